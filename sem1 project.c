@@ -1,928 +1,6495 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-
-// Define constants
-#define MAX_ROOMS 100
-#define MAX_NAME_LENGTH 50
-#define MAX_CONTACT_LENGTH 15
-
-// Enum for room types - more readable than magic numbers
-typedef enum
-{
-  SUITE = 1,
-  DOUBLE = 2,
-  SINGLE = 3
-} RoomType;
-
-// Pricing structure
-const float ROOM_RATES[] = {0.0, 1000.0, 600.0, 400.0}; // Index matches RoomType values
-
-// Date structure for check-in and check-out dates
-typedef struct
-{
-  int day;
-  int month;
-  int year;
-} Date;
-
-// Structure to store room booking details - expanded with more fields
-typedef struct
-{
-  int roomNumber;
-  char guestName[MAX_NAME_LENGTH];
-  char contact[MAX_CONTACT_LENGTH];
-  RoomType roomType;
-  int nights;
-  float totalPrice;
-  int isBooked;
-  Date checkInDate;
-  Date checkOutDate;
-} Room;
-
-// Function prototypes
-void addBooking(Room rooms[], int *roomCount);
-void deleteBooking(Room rooms[], int *roomCount);
-void displayBookings(Room rooms[], int roomCount);
-void searchBooking(Room rooms[], int roomCount);
-void modifyBooking(Room rooms[], int roomCount);
-void saveBookingsToFile(Room rooms[], int roomCount);
-void loadBookingsFromFile(Room rooms[], int *roomCount);
-int assignRoomNumber(Room rooms[], int roomCount, RoomType roomType);
-void displayMenu();
-int getValidInteger(const char *prompt);
-int validateContact(const char *contact);
-void calculateCheckOutDate(Date *checkIn, Date *checkOut, int nights);
-const char *getRoomTypeName(RoomType type);
-void getCurrentDate(Date *date);
-int isDateValid(Date date);
-void clearInputBuffer();
-
-// Main function
-int main()
-{
-  Room rooms[MAX_ROOMS] = {0};
-  int roomCount = 0;
-  int choice;
-
-  // Load bookings after the initial menu display
-  loadBookingsFromFile(rooms, &roomCount);
-
-  while (1)
-  {
-    system("cls"); // Clear screen before showing menu
-    displayMenu();
-    choice = getValidInteger("Enter your choice: ");
-
-    switch (choice)
-    {
-    case 1:
-      addBooking(rooms, &roomCount);
-      break;
-    case 2:
-      deleteBooking(rooms, &roomCount);
-      break;
-    case 3:
-      displayBookings(rooms, roomCount);
-      break;
-    case 4:
-      searchBooking(rooms, roomCount);
-      break;
-    case 5:
-      modifyBooking(rooms, roomCount);
-      break;
-    case 6:
-      saveBookingsToFile(rooms, roomCount);
-      printf("\nThank you for using Rasa Ria Room Booking System!\n");
-      return 0;
-    default:
-      printf("\n================================================\n");
-      printf("Invalid choice. Please enter a number from 1 to 6.\n");
-      printf("================================================\n");
-    }
-    printf("\nPress Enter to continue...");
-    getchar();
-  }
-
-  return 0;
-}
-
-// Function to display the main menu
-void displayMenu()
-{
-  printf("\n\n");
-  printf("\t\t=============================================\n");
-  printf("\t\t|                                           |\n");
-  printf("\t\t|       ----------------------------        |\n");
-  printf("\t\t|            RASA RIA ROOM BOOKING          |\n");
-  printf("\t\t|       ----------------------------        |\n");
-  printf("\t\t|                                           |\n");
-  printf("\t\t=============================================\n\n");
-  printf("===== RASA RIA HOTEL SERVICES =====\n");
-  printf("1. Add New Booking\n");
-  printf("2. Cancel Booking\n");
-  printf("3. Display All Bookings\n");
-  printf("4. Search for a Booking\n");
-  printf("5. Modify Existing Booking\n");
-  printf("6. Save & Exit\n");
-  printf("==================================\n");
-}
-
-// Function to clear input buffer
-void clearInputBuffer()
-{
-  int c;
-  while ((c = getchar()) != '\n' && c != EOF)
-    ;
-}
-
-// Function to get valid integer input
-int getValidInteger(const char *prompt)
-{
-  int value;
-  char line[256];
-
-  while (1)
-  {
-    printf("%s", prompt);
-    if (fgets(line, sizeof(line), stdin) == NULL)
-    {
-      continue;
-    }
-
-    if (sscanf(line, "%d", &value) == 1)
-    {
-      return value;
-    }
-
-    printf("Invalid input. Please enter a valid number.\n");
-  }
-}
-
-// Function to validate contact number 
-int validateContact(const char *contact)
-{
-  // Simple validation: must be between 8-12 digits
-  int len = strlen(contact);
-  if (len < 8 || len > 12)
-  {
-    return 0;
-  }
-  for (int i = 0; i < len; i++)
-  {
-    if (!((contact[i] >= '0' && contact[i] <= '9') || contact[i] == '-' || contact[i] == '+'))
-    {
-      return 0;
-    }
-  }
-  return 1;
-}
-
-// Function to get current date 
-void getCurrentDate(Date *date)
-{
-  printf("Enter today's date.\n");
-  printf("Day (DD): ");
-  scanf("%d", &date->day);
-  printf("Month (MM): ");
-  scanf("%d", &date->month);
-  printf("Year (YYYY): ");
-  scanf("%d", &date->year);
-}
-
-// Function to validate date
-int isDateValid(Date date)
-{
-  // Basic validation
-  if (date.month < 1 || date.month > 12)
-    return 0;
-
-  int daysInMonth[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-
-  // Adjust for leap year
-  if (date.year % 400 == 0 || (date.year % 100 != 0 && date.year % 4 == 0))
-  {
-    daysInMonth[2] = 29;
-  }
-
-  return (date.day > 0 && date.day <= daysInMonth[date.month]);
-}
-
-// Function to calculate check-out date (simple addition, no time.h)
-void calculateCheckOutDate(Date *checkIn, Date *checkOut, int nights)
-{
-  // Just add nights to the day (no month/year handling for simplicity)
-  checkOut->day = checkIn->day + nights;
-  checkOut->month = checkIn->month;
-  checkOut->year = checkIn->year;
-}
-
-// Function to get room type name string
-const char *getRoomTypeName(RoomType type)
-{
-  switch (type)
-  {
-  case SUITE:
-    return "Suite";
-  case DOUBLE:
-    return "Double";
-  case SINGLE:
-    return "Single";
-  default:
-    return "Unknown";
-  }
-}
-
-// Function to add a room booking
-void addBooking(Room rooms[], int *roomCount)
-{
-  if (*roomCount >= MAX_ROOMS)
-  {
-    printf("\n=============================================\n");
-    printf("No more rooms can be booked. Hotel is full!\n");
-    printf("=============================================\n");
-    return;
-  }
-
-  Room newBooking;
-  int roomTypeInput, nightsInput;
-
-  printf("\n=== ADDING NEW BOOKING ===\n");
-
-  printf("Enter guest name      : ");
-  clearInputBuffer(); // Clear any previous input
-  fgets(newBooking.guestName, sizeof(newBooking.guestName), stdin);
-  newBooking.guestName[strcspn(newBooking.guestName, "\n")] = '\0'; // Remove newline
-
-  do
-  {
-    printf("Enter contact number(8-12 digits) : ");
-    fgets(newBooking.contact, sizeof(newBooking.contact), stdin);
-    newBooking.contact[strcspn(newBooking.contact, "\n")] = '\0'; // Remove newline
-    if (!validateContact(newBooking.contact))
-    {
-      printf("Invalid contact number. Please enter 8-12 digits with optional +/- symbols.\n");
-    }
-  } while (!validateContact(newBooking.contact));
-
-  printf("Room Types:\n");
-  printf("1. Suite  - RM%.2f per night\n", ROOM_RATES[SUITE]);
-  printf("2. Double - RM%.2f per night\n", ROOM_RATES[DOUBLE]);
-  printf("3. Single - RM%.2f per night\n", ROOM_RATES[SINGLE]);
-
-  printf("Enter room type (1 for Suite, 2 for Double, 3 for Single): ");
-  if (scanf("%d", &roomTypeInput) != 1 || roomTypeInput < 1 || roomTypeInput > 3)
-  {
-    printf("===================================\n");
-    printf("Invalid input. Please enter a valid room type (1-3).\n");
-    printf("===================================\n");
-    while (getchar() != '\n')
-      ; // Clear the input buffer
-    return;
-  }
-  newBooking.roomType = (RoomType)roomTypeInput;
-
-  printf("Enter number of nights(1-30): ");
-  if (scanf("%d", &nightsInput) != 1 || nightsInput <= 0 || nightsInput > 30)
-  {
-    printf("===================================\n");
-    printf("Invalid input. Please enter a positive number of nights.\n");
-    printf("===================================\n");
-    while (getchar() != '\n')
-      ; // Clear the input buffer
-    return;
-  }
-  newBooking.nights = nightsInput;
-
-  // Get check-in date
-  printf("\nCheck-in Date:\n");
-  Date today;
-  getCurrentDate(&today);
-  printf("Today is: %02d/%02d/%04d\n", today.day, today.month, today.year);
-
-  // Allow booking starting from today up to 1 year in the future
-  do
-  {
-    printf("Enter check-in day (DD): ");
-    scanf("%d", &newBooking.checkInDate.day);
-    printf("Enter check-in month (MM): ");
-    scanf("%d", &newBooking.checkInDate.month);
-    printf("Enter check-in year (YYYY): ");
-    scanf("%d", &newBooking.checkInDate.year);
-
-    // Basic validation: check if date is valid and not in the past
-    if (!isDateValid(newBooking.checkInDate))
-    {
-      printf("Invalid date. Please enter a valid date.\n");
-      continue;
-    }
-
-    // Compare check-in date with today's date
-    if (newBooking.checkInDate.year < today.year ||
-        (newBooking.checkInDate.year == today.year &&
-         newBooking.checkInDate.month < today.month) ||
-        (newBooking.checkInDate.year == today.year &&
-         newBooking.checkInDate.month == today.month &&
-         newBooking.checkInDate.day < today.day))
-    {
-      printf("Check-in date cannot be in the past. Please enter a valid date.\n");
-      continue;
-    }
-
-    // Check if date is more than a year into the future
-    if (newBooking.checkInDate.year > today.year + 1 ||
-        (newBooking.checkInDate.year == today.year + 1 &&
-         newBooking.checkInDate.month > today.month) ||
-        (newBooking.checkInDate.year == today.year + 1 &&
-         newBooking.checkInDate.month == today.month &&
-         newBooking.checkInDate.day > today.day))
-    {
-      printf("Cannot book more than one year in advance. Please enter a valid date.\n");
-      continue;
-    }
-
-    break;
-  } while (1);
-
-  // Calculate check-out date
-  calculateCheckOutDate(&newBooking.checkInDate, &newBooking.checkOutDate, newBooking.nights);
-
-  // Calculate total price based on room type and number of nights
-  newBooking.totalPrice = ROOM_RATES[newBooking.roomType] * newBooking.nights;
-
-  // Assign a room number
-  newBooking.roomNumber = assignRoomNumber(rooms, *roomCount, newBooking.roomType);
-  if (newBooking.roomNumber == -1)
-  {
-    printf("\n==============================================\n");
-    printf("No available room of the selected type. Sorry!\n");
-    printf("==============================================\n");
-    clearInputBuffer();
-    return;
-  }
-
-  newBooking.isBooked = 1;
-  rooms[*roomCount] = newBooking;
-  (*roomCount)++;
-
-  clearInputBuffer();
-
-  printf("\n===========================================================\n");
-  printf("Booking added successfully!\n");
-  printf("Room number assigned: %d\n", newBooking.roomNumber);
-  printf("Check-in date: %02d/%02d/%04d\n",
-         newBooking.checkInDate.day, newBooking.checkInDate.month, newBooking.checkInDate.year);
-  printf("Check-out date: %02d/%02d/%04d\n",
-         newBooking.checkOutDate.day, newBooking.checkOutDate.month, newBooking.checkOutDate.year);
-  printf("Total price: $%.2f\n", newBooking.totalPrice);
-  printf("===========================================================\n");
-}
-
-// Function to assign room number based on room type
-int assignRoomNumber(Room rooms[], int roomCount, RoomType roomType)
-{
-  int start, end;
-
-  // Set room number ranges based on room type
-  switch (roomType)
-  {
-  case SUITE:
-    start = 1;
-    end = 20;
-    break;
-  case DOUBLE:
-    start = 21;
-    end = 60;
-    break;
-  case SINGLE:
-    start = 61;
-    end = 100;
-    break;
-  default:
-    return -1; // Invalid room type
-  }
-
-  // Find first available room number in the appropriate range
-  for (int i = start; i <= end; i++)
-  {
-    int available = 1;
-    for (int j = 0; j < roomCount; j++)
-    {
-      if (rooms[j].roomNumber == i && rooms[j].isBooked)
-      {
-        available = 0;
-        break;
-      }
-    }
-    if (available)
-    {
-      return i;
-    }
-  }
-
-  return -1; // No available room found
-}
-
-// Function to delete a room booking
-void deleteBooking(Room rooms[], int *roomCount)
-{
-  if (*roomCount == 0)
-  {
-    printf("\n===================\n");
-    printf("No bookings found.\n");
-    printf("===================\n");
-    return;
-  }
-
-  int roomNumber, index = -1;
-
-  roomNumber = getValidInteger("\nEnter room number to cancel: ");
-
-  for (int i = 0; i < *roomCount; i++)
-  {
-    if (rooms[i].roomNumber == roomNumber && rooms[i].isBooked)
-    {
-      index = i;
-      break;
-    }
-  }
-
-  if (index == -1)
-  {
-    printf("\n=====================================\n");
-    printf("Room %d not found or not booked.\n", roomNumber);
-    printf("=====================================\n");
-    return;
-  }
-
-  // Display booking details and confirm deletion
-  printf("\n=== BOOKING DETAILS ===\n");
-  printf("Room Number: %d\n", rooms[index].roomNumber);
-  printf("Guest Name : %s\n", rooms[index].guestName);
-  printf("Room Type  : %s\n", getRoomTypeName(rooms[index].roomType));
-  printf("Check-in   : %02d/%02d/%04d\n",
-         rooms[index].checkInDate.day, rooms[index].checkInDate.month, rooms[index].checkInDate.year);
-  printf("Check-out  : %02d/%02d/%04d\n",
-         rooms[index].checkOutDate.day, rooms[index].checkOutDate.month, rooms[index].checkOutDate.year);
-
-  char confirm;
-  printf("\nAre you sure you want to cancel this booking? (y/n): ");
-  clearInputBuffer();
-  scanf("%c", &confirm);
-
-  if (confirm == 'y' || confirm == 'Y')
-  {
-    for (int i = index; i < *roomCount - 1; i++)
-    {
-      rooms[i] = rooms[i + 1];
-    }
-    (*roomCount)--;
-
-    printf("\n===============================\n");
-    printf("Booking canceled successfully.\n");
-    printf("===============================\n");
-  }
-  else
-  {
-    printf("\n===================\n");
-    printf("Cancellation aborted.\n");
-    printf("===================\n");
-  }
-
-  clearInputBuffer();
-}
-
-// Function to display all room bookings
-void displayBookings(Room rooms[], int roomCount)
-{
-  if (roomCount == 0)
-  {
-    printf("\n===================\n");
-    printf("No bookings found.\n");
-    printf("===================\n");
-    return;
-  }
-
-  printf("\n========================== BOOKING DETAILS ==========================\n");
-  printf("%-5s %-20s %-15s %-10s %-12s %-12s %-10s\n",
-         "Room", "Guest Name", "Contact", "Type", "Check-in", "Check-out", "Price");
-  printf("--------------------------------------------------------------------\n");
-
-  for (int i = 0; i < roomCount; i++)
-  {
-    if (rooms[i].isBooked)
-    {
-      printf("%-5d %-20s %-15s %-10s %02d/%02d/%04d  %02d/%02d/%04d  $%-9.2f\n",
-             rooms[i].roomNumber,
-             rooms[i].guestName,
-             rooms[i].contact,
-             getRoomTypeName(rooms[i].roomType),
-             rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year,
-             rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year,
-             rooms[i].totalPrice);
-    }
-  }
-
-  printf("====================================================================\n");
-}
-
-// Function to search for a booking
-void searchBooking(Room rooms[], int roomCount)
-{
-  if (roomCount == 0)
-  {
-    printf("\n===================\n");
-    printf("No bookings found.\n");
-    printf("===================\n");
-    return;
-  }
-
-  printf("\n=== SEARCH BOOKING ===\n");
-  printf("1. Search by Room Number\n");
-  printf("2. Search by Guest Name\n");
-
-  int choice = getValidInteger("Enter your choice: ");
-
-  switch (choice)
-  {
-  case 1:
-  {
-    int roomNumber = getValidInteger("Enter room number: ");
-    int found = 0;
-
-    for (int i = 0; i < roomCount; i++)
-    {
-      if (rooms[i].roomNumber == roomNumber && rooms[i].isBooked)
-      {
-        found = 1;
-        printf("\n=== BOOKING DETAILS ===\n");
-        printf("Room Number: %d\n", rooms[i].roomNumber);
-        printf("Guest Name : %s\n", rooms[i].guestName);
-        printf("Contact    : %s\n", rooms[i].contact);
-        printf("Room Type  : %s\n", getRoomTypeName(rooms[i].roomType));
-        printf("Check-in   : %02d/%02d/%04d\n",
-               rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year);
-        printf("Check-out  : %02d/%02d/%04d\n",
-               rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year);
-        printf("Nights     : %d\n", rooms[i].nights);
-        printf("Total Price: $%.2f\n", rooms[i].totalPrice);
-        printf("=======================\n");
-        break;
-      }
-    }
-
-    if (!found)
-    {
-      printf("\n===================================\n");
-      printf("No booking found for Room %d.\n", roomNumber);
-      printf("===================================\n");
-    }
-    break;
-  }
-
-  case 2:
-  {
-    char searchName[MAX_NAME_LENGTH];
-    int found = 0;
-
-    printf("Enter guest name: ");
-    clearInputBuffer();
-    fgets(searchName, sizeof(searchName), stdin);
-    searchName[strcspn(searchName, "\n")] = '\0'; // Remove newline
-
-    printf("\n=== SEARCH RESULTS ===\n");
-    for (int i = 0; i < roomCount; i++)
-    {
-      // Case-sensitive partial name match (strstr)
-      if (rooms[i].isBooked && strstr(rooms[i].guestName, searchName) != NULL)
-      {
-        found = 1;
-        printf("\n--- Booking %d ---\n", found);
-        printf("Room Number: %d\n", rooms[i].roomNumber);
-        printf("Guest Name : %s\n", rooms[i].guestName);
-        printf("Contact    : %s\n", rooms[i].contact);
-        printf("Room Type  : %s\n", getRoomTypeName(rooms[i].roomType));
-        printf("Check-in   : %02d/%02d/%04d\n",
-               rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year);
-        printf("Check-out  : %02d/%02d/%04d\n",
-               rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year);
-        printf("Total Price: $%.2f\n", rooms[i].totalPrice);
-      }
-    }
-
-    if (!found)
-    {
-      printf("\n==========================================\n");
-      printf("No bookings found for guest: %s\n", searchName);
-      printf("==========================================\n");
-    }
-    else
-    {
-      printf("\n=== End of Search Results ===\n");
-    }
-    break;
-  }
-
-  default:
-    printf("\n==========================\n");
-    printf("Invalid choice. Try again.\n");
-    printf("==========================\n");
-    break;
-  }
-}
-
-// Function to modify an existing booking
-void modifyBooking(Room rooms[], int roomCount)
-{
-  if (roomCount == 0)
-  {
-    printf("\n===================\n");
-    printf("No bookings found.\n");
-    printf("===================\n");
-    return;
-  }
-
-  int roomNumber, index = -1;
-  roomNumber = getValidInteger("Enter room number to modify: ");
-
-  for (int i = 0; i < roomCount; i++)
-  {
-    if (rooms[i].roomNumber == roomNumber && rooms[i].isBooked)
-    {
-      index = i;
-      break;
-    }
-  }
-
-  if (index == -1)
-  {
-    printf("\n===================================\n");
-    printf("Room %d not found or not booked.\n", roomNumber);
-    printf("===================================\n");
-    return;
-  }
-
-  // Display current booking details
-  printf("\n=== CURRENT BOOKING DETAILS ===\n");
-  printf("1. Guest Name : %s\n", rooms[index].guestName);
-  printf("2. Contact    : %s\n", rooms[index].contact);
-  printf("3. Room Type  : %s\n", getRoomTypeName(rooms[index].roomType));
-  printf("4. Check-in   : %02d/%02d/%04d\n",
-         rooms[index].checkInDate.day, rooms[index].checkInDate.month, rooms[index].checkInDate.year);
-  printf("5. Nights     : %d\n", rooms[index].nights);
-  printf("6. Return to Main Menu\n");
-
-  int choice = getValidInteger("\nEnter what to modify (1-6): ");
-
-  switch (choice)
-  {
-  case 1:
-  {
-    printf("Enter new guest name: ");
-    clearInputBuffer();
-    fgets(rooms[index].guestName, sizeof(rooms[index].guestName), stdin);
-    rooms[index].guestName[strcspn(rooms[index].guestName, "\n")] = '\0'; // Remove newline
-    printf("\nGuest name updated successfully.\n");
-    break;
-  }
-
-  case 2:
-  {
-    char newContact[MAX_CONTACT_LENGTH];
-    do
-    {
-      printf("Enter new contact number: ");
-      clearInputBuffer();
-      fgets(newContact, sizeof(newContact), stdin);
-      newContact[strcspn(newContact, "\n")] = '\0'; // Remove newline
-
-      if (!validateContact(newContact))
-      {
-        printf("Invalid contact number. Please enter 8-12 digits with optional +/- symbols.\n");
-      }
-      else
-      {
-        strcpy(rooms[index].contact, newContact);
-        printf("\nContact updated successfully.\n");
-        break;
-      }
-    } while (1);
-    break;
-  }
-
-  case 3:
-  {
-    printf("Current room type: %s\n", getRoomTypeName(rooms[index].roomType));
-    printf("Room Types:\n");
-    printf("1. Suite  - $%.2f per night\n", ROOM_RATES[SUITE]);
-    printf("2. Double - $%.2f per night\n", ROOM_RATES[DOUBLE]);
-    printf("3. Single - $%.2f per night\n", ROOM_RATES[SINGLE]);
-
-    int newType;
-    do
-    {
-      newType = getValidInteger("Enter new room type (1-3): ");
-      if (newType < 1 || newType > 3)
-      {
-        printf("Invalid room type. Please enter 1, 2, or 3.\n");
-      }
-    } while (newType < 1 || newType > 3);
-
-    RoomType newRoomType = (RoomType)newType;
-
-    // Check if there's an available room of the new type
-    int newRoomNumber = assignRoomNumber(rooms, roomCount, newRoomType);
-
-    if (newRoomNumber == -1)
-    {
-      printf("\nNo available rooms of the selected type. Modification canceled.\n");
-      break;
-    }
-
-    // Update room type, room number, and recalculate price
-    rooms[index].roomType = newRoomType;
-    int oldRoomNumber = rooms[index].roomNumber;
-    rooms[index].roomNumber = newRoomNumber;
-    rooms[index].totalPrice = ROOM_RATES[newRoomType] * rooms[index].nights;
-
-    printf("\nRoom type updated successfully.\n");
-    printf("New room number: %d (was %d)\n", newRoomNumber, oldRoomNumber);
-    printf("New total price: $%.2f\n", rooms[index].totalPrice);
-    break;
-  }
-
-  case 4:
-  {
-    // Modify check-in date
-    Date today;
-    getCurrentDate(&today);
-    printf("Today is: %02d/%02d/%04d\n", today.day, today.month, today.year);
-
-    Date newCheckIn;
-    do
-    {
-      printf("Enter new check-in day (DD): ");
-      scanf("%d", &newCheckIn.day);
-      printf("Enter new check-in month (MM): ");
-      scanf("%d", &newCheckIn.month);
-      printf("Enter new check-in year (YYYY): ");
-      scanf("%d", &newCheckIn.year);
-
-      // Basic validation: check if date is valid and not in the past
-      if (!isDateValid(newCheckIn))
-      {
-        printf("Invalid date. Please enter a valid date.\n");
-        continue;
-      }
-
-      // Compare check-in date with today's date
-      if (newCheckIn.year < today.year ||
-          (newCheckIn.year == today.year && newCheckIn.month < today.month) ||
-          (newCheckIn.year == today.year && newCheckIn.month == today.month && newCheckIn.day < today.day))
-      {
-        printf("Check-in date cannot be in the past. Please enter a valid date.\n");
-        continue;
-      }
-
-      // Check if date is more than a year into the future
-      if (newCheckIn.year > today.year + 1 ||
-          (newCheckIn.year == today.year + 1 && newCheckIn.month > today.month) ||
-          (newCheckIn.year == today.year + 1 && newCheckIn.month == today.month && newCheckIn.day > today.day))
-      {
-        printf("Cannot book more than one year in advance. Please enter a valid date.\n");
-        continue;
-      }
-
-      break;
-    } while (1);
-
-    rooms[index].checkInDate = newCheckIn;
-    calculateCheckOutDate(&rooms[index].checkInDate, &rooms[index].checkOutDate, rooms[index].nights);
-
-    printf("\nCheck-in date updated successfully.\n");
-    printf("New check-in date: %02d/%02d/%04d\n",
-           rooms[index].checkInDate.day, rooms[index].checkInDate.month, rooms[index].checkInDate.year);
-    printf("New check-out date: %02d/%02d/%04d\n",
-           rooms[index].checkOutDate.day, rooms[index].checkOutDate.month, rooms[index].checkOutDate.year);
-    break;
-  }
-
-  case 5:
-  {
-    int newNights;
-    do
-    {
-      newNights = getValidInteger("Enter new number of nights (1-30): ");
-      if (newNights < 1 || newNights > 30)
-      {
-        printf("Invalid number of nights. Please enter a value between 1 and 30.\n");
-      }
-    } while (newNights < 1 || newNights > 30);
-
-    rooms[index].nights = newNights;
-    rooms[index].totalPrice = ROOM_RATES[rooms[index].roomType] * newNights;
-    calculateCheckOutDate(&rooms[index].checkInDate, &rooms[index].checkOutDate, newNights);
-
-    printf("\nBooking duration updated successfully.\n");
-    printf("New number of nights: %d\n", newNights);
-    printf("New check-out date: %02d/%02d/%04d\n",
-           rooms[index].checkOutDate.day, rooms[index].checkOutDate.month, rooms[index].checkOutDate.year);
-    printf("New total price: $%.2f\n", rooms[index].totalPrice);
-    break;
-  }
-
-  case 6:
-    printf("Returning to main menu.\n");
-    break;
-
-  default:
-    printf("\n==========================\n");
-    printf("Invalid choice. Try again.\n");
-    printf("==========================\n");
-    break;
-  }
-
-  clearInputBuffer();
-}
-
-// Function to save bookings to a file in text format
-void saveBookingsToFile(Room rooms[], int roomCount)
-{
-  FILE *file = fopen("bookings.txt", "w");
-  if (file == NULL)
-  {
-    printf("\n====================================\n");
-    printf("Error: Unable to save bookings to file.\n");
-    printf("====================================\n");
-    return;
-  }
-
-  fprintf(file, "%d\n", roomCount);
-  for (int i = 0; i < roomCount; i++)
-  {
-    fprintf(file, "%d\n%s\n%s\n%d\n%d\n%f\n%d\n%d %d %d\n%d %d %d\n",
-            rooms[i].roomNumber,
-            rooms[i].guestName,
-            rooms[i].contact,
-            rooms[i].roomType,
-            rooms[i].nights,
-            rooms[i].totalPrice,
-            rooms[i].isBooked,
-            rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year,
-            rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year);
-  }
-
-  fclose(file);
-  printf("\n============================\n");
-  printf("Bookings saved successfully.\n");
-  printf("============================\n");
-}
-
-// Function to load bookings from a file in text format
-void loadBookingsFromFile(Room rooms[], int *roomCount)
-{
-  FILE *file = fopen("bookings.txt", "r");
-  if (file == NULL)
-  {
-    printf("No previous bookings found.\n");
-    return;
-  }
-
-  if (fscanf(file, "%d\n", roomCount) != 1)
-  {
-    printf("Error reading booking count from file.\n");
-    fclose(file);
-    return;
-  }
-
-  for (int i = 0; i < *roomCount; i++)
-  {
-    if (fscanf(file, "%d\n", &rooms[i].roomNumber) != 1)
-      break;
-    if (fgets(rooms[i].guestName, sizeof(rooms[i].guestName), file) == NULL)
-      break;
-    rooms[i].guestName[strcspn(rooms[i].guestName, "\n")] = '\0';
-    if (fgets(rooms[i].contact, sizeof(rooms[i].contact), file) == NULL)
-      break;
-    rooms[i].contact[strcspn(rooms[i].contact, "\n")] = '\0';
-    int roomType;
-    if (fscanf(file, "%d\n", &roomType) != 1)
-      break;
-    rooms[i].roomType = (RoomType)roomType;
-    if (fscanf(file, "%d\n", &rooms[i].nights) != 1)
-      break;
-    if (fscanf(file, "%f\n", &rooms[i].totalPrice) != 1)
-      break;
-    if (fscanf(file, "%d\n", &rooms[i].isBooked) != 1)
-      break;
-    if (fscanf(file, "%d %d %d\n",
-               &rooms[i].checkInDate.day, &rooms[i].checkInDate.month, &rooms[i].checkInDate.year) != 3)
-      break;
-    if (fscanf(file, "%d %d %d\n",
-               &rooms[i].checkOutDate.day, &rooms[i].checkOutDate.month, &rooms[i].checkOutDate.year) != 3)
-      break;
-  }
-
-  fclose(file);
-  printf("Bookings loaded successfully.\n");
-}
\ No newline at end of file
+#define _POSIX_C_SOURCE 200809L // clock_gettime/nanosleep for session replay on POSIX systems
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN // Only the timer and Sleep calls are needed
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Define constants
+#define MAX_ROOMS 2000        // Rooms in the inventory
+#define MAX_ROOM_NUMBER 9999  // Highest room number the inventory may use
+#define MAX_ROOM_TYPES 16
+#define MAX_TYPE_NAME 16
+#define MAX_BOOKINGS 100000   // Bookings held in memory: a year of stays on a 1000-room property, with room to spare
+#define MAX_NAME_LENGTH 50
+#define MAX_CONTACT_LENGTH 15
+
+// Booking store files - the snapshot plus a journal of every change made since it was written
+#define BOOKINGS_FILE "bookings.txt"
+#define BOOKINGS_TEMP_FILE "bookings.tmp"
+#define JOURNAL_FILE "bookings.journal"
+#define JOURNAL_LINE_LENGTH (MAX_NAME_LENGTH + MAX_CONTACT_LENGTH + 128)
+#define JOURNAL_FORMAT_VERSION 2 // Written after the generation; entries name bookings by id
+
+// Columnar analytics export settings
+#define EXPORT_FILE "bookings_export.col"
+#define EXPORT_ROWS_PER_GROUP 4096
+#define EXPORT_DICT_SLOTS (2 * EXPORT_ROWS_PER_GROUP) // Hash slots for the per-group name dictionary
+#define EXPORT_MAX_GROUP_BYTES (EXPORT_ROWS_PER_GROUP * (MAX_NAME_LENGTH + 32) + 128) // Sanity limit for readers
+
+// Archive (cold storage) settings for completed stays
+#define ARCHIVE_FILE "bookings_archive.dat"
+#define ARCHIVE_INDEX_FILE "bookings_archive.idx"
+#define ARCHIVE_BLOCK_RECORDS 64 // Stays per compressed block
+#define ARCHIVE_RECORD_MAX_BYTES (MAX_NAME_LENGTH + MAX_CONTACT_LENGTH + 40) // Worst-case encoded stay
+#define ARCHIVE_INDEX_MAGIC "RRIDXv2"  // 8 bytes with the terminator, at the start of the index file
+#define ARCHIVE_INDEX_ENTRY_BYTES 28   // 64-bit offset + five 32-bit fields, all little-endian
+
+// Room inventory file - room types, rates and the rooms themselves (built-in layout if missing)
+#define ROOM_CONFIG_FILE "rooms.cfg"
+#define ROOM_TYPES_FILE "bookings.types" // Type number -> name, as used by the saved bookings
+#define CONFIG_LINE_LENGTH 256
+
+// Room types are numbered 1..typeCount in the order the inventory lists them
+typedef int RoomType;
+
+// Room attributes - one bit each, so a room's features are a single mask
+#define ATTR_SEA_VIEW 0x01u
+#define ATTR_ACCESSIBLE 0x02u
+#define ATTR_CONNECTING 0x04u
+#define ATTR_SMOKING 0x08u
+#define ATTR_COUNT 4
+const char *ATTRIBUTE_NAMES[ATTR_COUNT] = {"seaview", "accessible", "connecting", "smoking"}; // Bit order
+
+// One room as read from the inventory file
+typedef struct
+{
+  int number;
+  RoomType type;
+  int floor;
+  unsigned int attributes;
+} InventoryRoom;
+
+// One room type with its slice of the room table
+typedef struct
+{
+  char name[MAX_TYPE_NAME];
+  float rate;  // Price per night
+  int first;   // First slot of this type in the room table
+  int count;   // Rooms of this type
+} RoomTypeInfo;
+
+// The room inventory. Rooms are kept grouped by type, then by attribute set (plain rooms first),
+// then by room number, in parallel arrays so an attribute scan reads one packed array.
+typedef struct
+{
+  RoomTypeInfo types[MAX_ROOM_TYPES + 1]; // Index 0 unused, so RoomType values index it directly
+  int typeCount;
+  int roomNumber[MAX_ROOMS];
+  int floor[MAX_ROOMS];
+  unsigned int attributes[MAX_ROOMS];
+  int roomCount;
+  int highestRoom;                   // Highest room number in use
+  unsigned int attributesUsed;       // Attributes at least one room has
+  short slotOfRoom[MAX_ROOM_NUMBER + 1]; // Slot of each room number, -1 if there is no such room
+} RoomInventory;
+
+RoomInventory inventory;
+
+// Date structure for check-in and check-out dates
+typedef struct
+{
+  int day;
+  int month;
+  int year;
+} Date;
+
+// Structure to store room booking details - expanded with more fields
+typedef struct
+{
+  int bookingId; // Stable id, never reused; journal entries refer to bookings by it
+  int roomNumber;
+  char guestName[MAX_NAME_LENGTH];
+  char contact[MAX_CONTACT_LENGTH];
+  RoomType roomType;
+  int nights;
+  float totalPrice;
+  int isBooked;
+  Date checkInDate;
+  Date checkOutDate;
+} Room;
+
+// Sparse index entry - one per compressed block in the archive file
+typedef struct
+{
+  long long offset;       // Byte offset of the block header in the archive file
+  int length;             // Encoded block length in bytes (excluding header)
+  int count;              // Number of stays in the block
+  int minCheckIn;         // Earliest check-in in the block (day number)
+  int maxCheckOut;        // Latest check-out in the block (day number)
+  unsigned int guestMask; // Letters/digits appearing in any guest name of the block
+} ArchiveIndexEntry;
+
+// One stay as a night interval, used when repacking room assignments
+typedef struct
+{
+  int index;      // Booking index in rooms[]
+  int room;       // Current room (offset within its type range, -1 if outside)
+  int checkIn;    // First night (day number)
+  int checkOut;   // Check-out day (day number, exclusive)
+  int packedRoom; // Room chosen by the repacking sweep
+} StaySpan;
+
+// One compiled condition of a filter query
+#define MAX_FILTER_TERMS 8
+#define QUERY_INDEX_MIN_ROWS 256 // Smaller tables are always scanned
+typedef struct FilterTerm
+{
+  int (*test)(const struct FilterTerm *term, const Room *room); // Test bound at compile time
+  int (*column)(const Room *room);                              // Integer column for range tests
+  int low, high;                                                // Inclusive range (low is the value for !=)
+  char text[MAX_NAME_LENGTH];                                   // Pattern for name/contact tests
+  int cost;                                                     // 0 range, 1 not-equal, 2 string
+} FilterTerm;
+
+// A compiled filter query - built once, then run over every booking
+typedef struct
+{
+  FilterTerm terms[MAX_FILTER_TERMS];
+  int termCount;
+  int matchesNothing;              // Contradictory ranges, skip the scan
+  int (*sortColumn)(const Room *); // ORDER BY column, NULL for booking order
+  int descending;
+  int limit;                       // 0 for no limit
+  int indexTerm;                   // Range term read through a column index, -1 to scan
+} BookingQuery;
+
+// Sorted index over one integer column, so a query reads only the rows inside a range.
+// Built on first use and rebuilt after any change to the bookings.
+typedef struct
+{
+  int (*column)(const Room *room);
+  int *keys;           // Column values in ascending order
+  int *rows;           // Booking index of each value
+  int capacity;
+  int count;
+  const Room *rooms;   // Table and bookings version the index was built from
+  unsigned int version;
+} ColumnIndex;
+
+// Position of a reader in the journal (the primary at start-up, or a follower process)
+typedef struct
+{
+  int generation; // Snapshot generation the journal belongs to
+  long offset;    // Byte offset of the next unread journal line
+  int applied;    // Journal entries applied since the snapshot was loaded
+  int loaded;     // Snapshot has been loaded at least once
+} JournalReader;
+
+// Columnar export writer - holds exactly one row group, so memory stays constant
+// however many stays are exported
+typedef struct
+{
+  FILE *file;
+  int rows;                                                 // Rows buffered in the current group
+  long totalRows;
+  int groups;
+  unsigned long long checksum;                              // Sum of columnarRowHash() over written rows
+  unsigned char room[EXPORT_ROWS_PER_GROUP * 5];            // Varint room numbers
+  unsigned char type[EXPORT_ROWS_PER_GROUP];                // One byte per row
+  unsigned char checkIn[EXPORT_ROWS_PER_GROUP * 5];         // Zigzag varint deltas of check-in day numbers
+  unsigned char nights[EXPORT_ROWS_PER_GROUP * 5];          // Varint nights
+  unsigned char price[EXPORT_ROWS_PER_GROUP * 5];           // Varint price in cents
+  unsigned char name[EXPORT_ROWS_PER_GROUP * 5];            // Varint dictionary ids
+  int roomLength, checkInLength, nightsLength, priceLength, nameLength;
+  int prevCheckIn;
+  int minRoom, maxRoom, minCheckIn, maxCheckIn, minCheckOut, maxCheckOut, minPrice, maxPrice;
+  char dictionary[EXPORT_ROWS_PER_GROUP][MAX_NAME_LENGTH]; // Distinct guest names in the group
+  int dictionaryCount;
+  int dictionarySlots[EXPORT_DICT_SLOTS];                   // Hash of names to dictionary ids, -1 empty
+} ColumnarWriter;
+
+// Availability cache: answers to "which room of type T (with these attributes) is free from
+// check-in to check-out".
+// Each answer remembers the epoch of its room type; any change to that type's bookings bumps
+// the epoch, so stale answers are recognised in O(1) without scanning the cache.
+#define AVAILABILITY_CACHE_SLOTS 256 // Direct-mapped, must be a power of two
+typedef struct
+{
+  int roomType;       // 0 for an empty slot
+  int checkIn;        // Day number
+  int checkOut;       // Day number (exclusive)
+  unsigned int mustHave, prefer; // Attribute masks of the question
+  unsigned int epoch; // Room type epoch the answer was computed in
+  int roomNumber;     // Best free room, -1 if none
+  int freeRooms;      // Free rooms of the type with every must-have attribute
+} AvailabilityCacheEntry;
+
+AvailabilityCacheEntry availabilityCache[AVAILABILITY_CACHE_SLOTS];
+unsigned int availabilityEpoch[MAX_ROOM_TYPES + 1]; // Bumped on every change to a room type's bookings
+unsigned int bookingsVersion = 0; // Bumped with any availability epoch, so it moves on every change
+
+// Filter query column indexes (one per integer column) and rows read by the last query
+#define QUERY_INDEX_COLUMNS 6
+ColumnIndex queryIndexes[QUERY_INDEX_COLUMNS];
+int queryRowsRead = 0;
+long availabilityHits = 0, availabilityMisses = 0;
+
+// Shared-memory booking store (started with --shared): every front-desk process on the host
+// works on one live table instead of a private copy. Changes are made under a process-shared
+// robust mutex, so a desk that crashes in the middle of a change cannot block the others.
+#define SHARED_STORE_NAME "/rasaria_bookings"
+#define SHARED_STORE_MAGIC 0x52525348u  // Set once the table is loaded
+#define SHARED_STORE_CLOSED 0x434c5344u // Set when the store is retired; attaching desks start over
+#define SHARED_STORE_VERSION 2          // Bump whenever Room or SharedBookingStore changes layout
+#define SHARED_STORE_MAX_DESKS 32
+#define SHARED_STORE_WAIT_LIMIT 3000 // 10 ms waits for another desk to finish loading the table
+#ifndef _WIN32
+// The header comes first and keeps its layout, so a desk can recognise a store made by another build
+typedef struct
+{
+  unsigned int magic;                // SHARED_STORE_MAGIC while open, SHARED_STORE_CLOSED once retired
+  unsigned int layoutVersion;        // SHARED_STORE_VERSION of the build that created the store
+  unsigned long long storeSize;      // sizeof(SharedBookingStore) in that build
+  int maxBookings;                   // MAX_BOOKINGS in that build
+  int creatorPid;                    // Desk loading the table; another desk takes over if it dies first
+  int desks[SHARED_STORE_MAX_DESKS]; // Process ids of the attached desks, 0 for a free slot
+} SharedStoreHeader;
+
+typedef struct
+{
+  SharedStoreHeader header;
+  pthread_mutex_t lock; // Process-shared, robust
+  unsigned int changes; // Bumped by every committed change
+  int businessDay;
+  int nextBookingId;
+  long long archiveCommittedBytes;
+  int archiveCommittedBlocks;
+  int roomCount;
+  Room rooms[MAX_BOOKINGS];
+} SharedBookingStore;
+
+SharedBookingStore *sharedStore = NULL; // NULL when bookings are private to this process
+const char *sharedStoreName = SHARED_STORE_NAME; // Name of the shared memory object (checks use their own)
+#endif
+unsigned int sharedChangesSeen = 0; // Store version this process's heap and cache were built from
+
+// Check-out min-heap for the night audit: booking indexes ordered by check-out day.
+// It lives for the whole session, is updated on every add/modify and rebuilt when bookings are removed.
+int checkoutHeap[MAX_BOOKINGS];    // Booking indexes, earliest check-out in slot 0
+int checkoutHeapKey[MAX_BOOKINGS]; // Check-out day of the booking in each slot
+int checkoutHeapPos[MAX_BOOKINGS]; // Slot of each booking index, -1 if not in the heap
+int checkoutHeapSize = 0;
+int businessDay = 0; // Current business date (day number), 0 until the first night audit
+int nextBookingId = 1; // Id for the next new booking (kept in the snapshot header)
+
+// Archive blocks covered by the current snapshot. Blocks written past this point belong to an
+// archive run whose snapshot was never saved; they are ignored and later overwritten.
+long long archiveCommittedBytes = 0;
+int archiveCommittedBlocks = 0;
+
+// Session recording (--record) for load-test replays (--replay)
+#define TRACE_FORMAT_VERSION 4      // Bookings are named by id; adds and groups keep their requested features
+FILE *traceFile = NULL;     // Trace being written, NULL when the session is not recorded
+long long traceStartMicros; // Clock reading when the recording started
+int journalEnabled = 1;     // Replays run in memory only and must not write the journal
+
+// Overbooking simulation (--simulate): Monte Carlo scenarios of cancellations, no-shows and
+// late bookings run against a snapshot of the store, once per overbooking level.
+#define SIM_DEFAULT_SCENARIOS 10000
+#define SIM_MAX_THREADS 64
+#define SIM_HORIZON_DAYS 365
+#define SIM_LEVELS 6             // Levels tried: 0%, 3%, ... 15% more bookings than rooms per type
+#define SIM_LEVEL_STEP_PERCENT 3
+#define SIM_DEMAND 1.10          // Late booking requests, in room-nights per room-night of capacity
+#define SIM_MAX_NIGHTS 7         // Late bookings stay 1..SIM_MAX_NIGHTS nights
+#define SIM_MAX_LEAD_DAYS 60     // and are made up to this many days before check-in
+#define SIM_CANCEL_RATE 0.10
+#define SIM_NO_SHOW_RATE 0.05
+#define SIM_WALK_COST_NIGHTS 2.0 // Cost of walking a guest to another hotel, in nights of the room rate
+#define SIM_SEED 0x5241534152494153ULL // Fixed, so the same store always gives the same report
+
+// One stay in a scenario: a booking already on the book or a late booking request
+typedef struct
+{
+  RoomType type;
+  int roomNumber; // Room of a stay already in progress, 0 otherwise
+  int checkIn;    // Day number
+  int nights;
+  int requestDay; // Day the request arrives, -1 for bookings already on the book
+  int cancelDay;  // Day the booking is cancelled, -1 if it is kept
+  int showsUp;
+  float price;
+} SimStay;
+
+// Totals for one overbooking level, summed over scenarios
+typedef struct
+{
+  long accepted; // Late requests taken
+  double walkOuts;
+  double revenue, netRevenue, netRevenueSquared;
+  int scenariosWithWalkOut;
+} SimLevelResult;
+
+// One simulation thread. Scenarios are claimed from a shared counter, so a thread that finishes
+// early simply takes more; everything a scenario allocates comes from the thread's own arena.
+typedef struct
+{
+#ifndef _WIN32
+  pthread_t thread;
+#endif
+  unsigned long long random; // Per-thread generator, reseeded from the scenario number
+  unsigned char *arena;
+  size_t arenaSize, arenaUsed;
+  SimLevelResult levels[SIM_LEVELS];
+} SimWorker;
+
+// Read-only snapshot shared by all simulation threads
+SimStay *simBooked = NULL; // Bookings still to arrive or in progress on the first day
+int simBookedCount = 0;
+int *simBaseBookCount = NULL; // Booked rooms per type and night, [type * simCountDays + night]
+int simStartDay, simCountDays, simRequestBound, simScenarios;
+int simRequestChunks[MAX_ROOM_TYPES + 1];          // Late requests per type and day are drawn as a sum of
+double simRequestChunkLimit[MAX_ROOM_TYPES + 1];   // Poisson chunks with mean <= 8; limit is exp(-chunk mean)
+int simRequestCap[MAX_ROOM_TYPES + 1];             // Most requests per type and day (keeps the arena bounded)
+volatile int simNextScenario = 0;
+int simFailedScenario = -1; // Scenario that could not run, -1 while all is well (atomic access only)
+
+// Function prototypes
+void addBooking(Room rooms[], int *roomCount);
+void deleteBooking(Room rooms[], int *roomCount);
+void displayBookings(Room rooms[], int roomCount);
+void searchBooking(Room rooms[], int roomCount);
+void modifyBooking(Room rooms[], int *roomCount);
+void saveBookingsToFile(Room rooms[], int roomCount);
+void loadBookingsFromFile(Room rooms[], int *roomCount);
+void useDefaultInventory();
+int addInventoryRooms(InventoryRoom list[], int *count, int firstNumber, int lastNumber, RoomType type,
+                      int floor, unsigned int attributes);
+int compareInventoryRoom(const void *a, const void *b);
+void indexRoomInventory(InventoryRoom list[], int count);
+int loadRoomInventory(const char *path);
+int checkRoomTypeNames(const char *path);
+int isValidRoomType(int type);
+float getRoomTypeRate(RoomType type);
+int roomSlot(int roomNumber);
+unsigned int roomAttributes(int roomNumber);
+int parseRoomAttributes(const char *text, unsigned int *attributes);
+void formatRoomAttributes(unsigned int attributes, char *buf, int size);
+int countBits(unsigned int value);
+int compareRoomNumber(const void *a, const void *b);
+void printRoomTypes();
+unsigned int readRoomAttributes(const char *prompt);
+void markOccupiedRooms(Room rooms[], int roomCount, Date checkIn, int nights, int skipIndex,
+                       unsigned char occupied[]);
+int isRoomFree(Room rooms[], int roomCount, int roomNumber, Date checkIn, int nights, int skipIndex);
+int pickFreeRoom(RoomType roomType, const unsigned char occupied[], unsigned int mustHave, unsigned int prefer,
+                 int *freeRooms);
+int findFreeRoom(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights, int skipIndex,
+                 unsigned int mustHave, unsigned int prefer, int *freeRooms);
+int assignRoomNumber(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights, int skipIndex);
+int assignMatchingRoom(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights, int skipIndex,
+                       unsigned int mustHave, unsigned int prefer);
+void invalidateAvailability(RoomType roomType);
+void invalidateAllAvailability();
+int quoteAvailability(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights,
+                      unsigned int mustHave, unsigned int prefer, int *freeRooms);
+void checkAvailability(Room rooms[], int roomCount);
+int findGroupRoomBlock(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights,
+                       int roomsNeeded, unsigned int mustHave, int roomNumbers[]);
+int bookRoomBlock(Room rooms[], int *roomCount, const Room *booking, int roomsNeeded, unsigned int mustHave,
+                  int roomNumbers[]);
+void insertBooking(Room rooms[], int *roomCount, const Room *booking, unsigned int mustHave, unsigned int prefer);
+void updateBookingAt(Room rooms[], int index, const Room *updated);
+void cancelBookingAt(Room rooms[], int *roomCount, int index);
+void addGroupBooking(Room rooms[], int *roomCount);
+int findBookingByRoom(Room rooms[], int roomCount, int roomNumber);
+void readCheckInDate(Date *checkIn);
+void displayMenu();
+int getValidInteger(const char *prompt);
+int validateContact(const char *contact);
+void calculateCheckOutDate(Date *checkIn, Date *checkOut, int nights);
+const char *getRoomTypeName(RoomType type);
+void getCurrentDate(Date *date);
+void getBusinessDate(Date *date);
+int isDateValid(Date date);
+void clearInputBuffer();
+int dateToDayNumber(Date date);
+void dayNumberToDate(int dayNumber, Date *date);
+int putVarint(unsigned char *buf, unsigned int value);
+int getVarint(const unsigned char *buf, int *pos, int len, unsigned int *value);
+unsigned int guestNameMask(const char *name);
+int encodeArchiveRecord(const Room *room, int prevCheckIn, unsigned char *buf);
+int decodeArchiveRecord(const unsigned char *buf, int *pos, int len, int prevCheckIn, Room *room);
+int compareCheckIn(const void *a, const void *b);
+int archiveCompletedStays(Room rooms[], int *roomCount, Date today);
+void searchArchive(const char *guestName, int dayNumber);
+int readInt32(FILE *file, int *value);
+FILE *openArchiveIndex(const char *mode);
+void writeArchiveIndexEntry(FILE *index, const ArchiveIndexEntry *entry);
+int readArchiveIndexEntry(FILE *index, ArchiveIndexEntry *entry);
+int readArchiveBlock(FILE *archive, const ArchiveIndexEntry *entry, Room stays[]);
+void stayHistoryMenu(Room rooms[], int *roomCount);
+int compareStaySpan(const void *a, const void *b);
+int compareStayRoom(const void *a, const void *b);
+int countFreeRuns(Room rooms[], int roomCount, const int roomNumbers[], int fromDay);
+int planClassRepacking(Room rooms[], int roomCount, RoomType roomType, int first, int classRooms, int today,
+                       int newRoomNumbers[]);
+int planRoomRepacking(Room rooms[], int roomCount, Date today, int newRoomNumbers[],
+                      int *runsBefore, int *runsAfter);
+void optimizeRoomAssignments(Room rooms[], int *roomCount);
+void printBookingRow(const Room *room);
+int equalsIgnoreCase(const char *a, const char *b);
+int containsIgnoreCase(const char *text, const char *pattern);
+int columnRoom(const Room *room);
+int columnType(const Room *room);
+int columnNights(const Room *room);
+int columnPrice(const Room *room);
+int columnCheckIn(const Room *room);
+int columnCheckOut(const Room *room);
+int testIntRange(const FilterTerm *term, const Room *room);
+int testIntNotEqual(const FilterTerm *term, const Room *room);
+int testNameContains(const FilterTerm *term, const Room *room);
+int testNameEquals(const FilterTerm *term, const Room *room);
+int testContactContains(const FilterTerm *term, const Room *room);
+int testContactEquals(const FilterTerm *term, const Room *room);
+int nextQueryToken(const char **cursor, char *token, int tokenSize);
+int parseQueryNumber(const char *text, int *number);
+int parseQueryPrice(const char *text, int *cents);
+int parseQueryDate(const char *text, int *dayNumber);
+int (*queryColumn(const char *field))(const Room *);
+int compileBookingQuery(const char *text, BookingQuery *query, char *error, int errorSize);
+int queryHeapAbove(const BookingQuery *query, const int keys[], int a, int b);
+int queryIndexRank(const FilterTerm *term);
+int compareIndexedRow(const void *a, const void *b);
+ColumnIndex *getColumnIndex(Room rooms[], int roomCount, int (*column)(const Room *));
+int indexedQueryRows(Room rooms[], int roomCount, const BookingQuery *query, int rows[]);
+int runBookingQuery(Room rooms[], int roomCount, const BookingQuery *query, int results[]);
+void filterBookings(Room rooms[], int roomCount);
+void formatJournalRecord(const Room *room, char *buf, int size);
+int parseJournalRecord(const char *text, Room *room);
+int formatJournalEntry(char op, const Room *oldBooking, const Room *newBooking, char *line, int size);
+void writeJournalLine(const char *line);
+void appendJournal(char op, const Room *oldBooking, const Room *newBooking);
+void resetJournal();
+int findBookingById(Room rooms[], int roomCount, int bookingId);
+int applyJournalLine(Room rooms[], int *roomCount, const char *line);
+int checkJournalGroup(FILE *file, const char *beginLine);
+int followJournal(Room rooms[], int *roomCount, JournalReader *reader);
+void displayOccupancyReport(Room rooms[], int roomCount);
+int runFollower();
+void swapCheckoutSlots(int a, int b);
+void siftCheckoutUp(int slot);
+void siftCheckoutDown(int slot);
+void removeCheckoutSlot(int slot);
+void rebuildCheckoutHeap(Room rooms[], int roomCount);
+void trackCheckout(Room rooms[], int index);
+int releaseEndedStays(Room rooms[], int newBusinessDay, int releasedIndexes[]);
+void nightAudit(Room rooms[]);
+void writeInt32(FILE *file, int value);
+void resetColumnarGroup(ColumnarWriter *writer);
+int flushColumnarGroup(ColumnarWriter *writer);
+int addColumnarRow(ColumnarWriter *writer, const Room *room);
+int exportArchivedStays(ColumnarWriter *writer);
+long exportColumnar(Room rooms[], int roomCount, const char *path);
+unsigned long long columnarRowHash(const Room *stay);
+void addColumnarChecksum(const Room *stay, void *context);
+int getInt32(const unsigned char *buf, int *pos, int len, int *value);
+int decodeColumnarGroup(const unsigned char *group, int length, int rows, char dictionary[][MAX_NAME_LENGTH],
+                        void (*visit)(const Room *stay, void *context), void *context);
+long readColumnar(const char *path, void (*visit)(const Room *stay, void *context), void *context);
+int verifyColumnarExport(const char *path);
+long long getMicroseconds();
+void sleepMicroseconds(long long micros);
+void recordTrace(const char *line);
+int startTraceRecording(Room rooms[], int roomCount, const char *path);
+void finishTraceRecording(Room rooms[], int roomCount);
+unsigned long long bookingStoreChecksum(Room rooms[], int roomCount);
+int compareLatency(const void *a, const void *b);
+int replayTraceOperation(Room rooms[], int *roomCount, const char *op, int *refused);
+int runReplay(const char *path, double speed);
+#ifndef _WIN32
+int processAlive(int pid);
+int countSharedDesks(SharedStoreHeader *header, int self);
+int retireSharedStore(SharedStoreHeader *header);
+void loadSharedStore(SharedBookingStore *store);
+int waitForSharedStore(SharedBookingStore *store, int self);
+#endif
+int openSharedStore(Room **rooms, int **roomCount);
+void closeSharedStore();
+void lockBookingStore();
+void unlockBookingStore(int changed);
+unsigned int bookingStoreVersion();
+int sameBooking(const Room *a, const Room *b);
+int relockBooking(Room rooms[], int roomCount, const Room *booking);
+Room *viewBookingStore(Room rooms[], int *roomCount, int *viewCount);
+unsigned long long simNextRandom(unsigned long long *state);
+double simUniform(unsigned long long *state);
+int simPoisson(unsigned long long *state, int chunks, double chunkLimit, int cap);
+double simSquareRoot(double value);
+void *simArenaAlloc(SimWorker *worker, size_t size);
+void simBuildBuckets(const int keys[], int count, int days, int offsets[], int order[]);
+void simBookNights(int bookCount[], const SimStay *stay, int delta);
+int simCanBook(const int bookCount[], const SimStay *stay, int limit);
+int runSimulationScenario(SimWorker *worker, int scenario);
+int claimSimulationScenario();
+int loadFailedScenario();
+void storeFailedScenario(int scenario);
+void *runSimulationWorker(void *arg);
+int prepareSimulation(Room rooms[], int roomCount, int startDay);
+int simulateOverbooking(Room rooms[], int roomCount, int startDay, int scenarios, int threads, size_t arenaSize,
+                        SimLevelResult total[]);
+int runOverbookingSimulation(int scenarios, int threads);
+
+// Main function
+int main(int argc, char *argv[])
+{
+  if (loadRoomInventory(ROOM_CONFIG_FILE) < 0)
+  {
+    printf("Error: Fix %s (or remove it to use the built-in rooms) and start again.\n", ROOM_CONFIG_FILE);
+    return 1;
+  }
+
+  if (argc > 1 && strcmp(argv[1], "--verify-export") == 0)
+  {
+    return verifyColumnarExport(argc > 2 ? argv[2] : EXPORT_FILE);
+  }
+  if (argc > 2 && strcmp(argv[1], "--replay") == 0)
+  {
+    // Load-test driver: replay a recorded session at 1x, Nx or maximum ("max") speed
+    double speed = 1.0;
+    if (argc > 3 && strcmp(argv[3], "max") == 0)
+      speed = 0.0;
+    else if (argc > 3)
+    {
+      char *end;
+      speed = strtod(argv[3], &end);
+      if (end == argv[3] || *end != '\0' || !(speed > 0))
+      {
+        printf("Error: Invalid replay speed '%s' (use a positive number or \"max\").\n", argv[3]);
+        return 1;
+      }
+    }
+    return runReplay(argv[2], speed);
+  }
+  // Everything below reads the saved bookings, whose room types must still mean the same rooms
+  if (!checkRoomTypeNames(ROOM_TYPES_FILE))
+  {
+    printf("Error: Room types in %s may not be reordered or removed (add new ones at the end).\n",
+           ROOM_CONFIG_FILE);
+    return 1;
+  }
+  if (argc > 1 && strcmp(argv[1], "--follower") == 0)
+  {
+    return runFollower();
+  }
+  if (argc > 1 && strcmp(argv[1], "--export") == 0)
+  {
+    // Non-interactive export for scheduled jobs: snapshot + journal + archive, read-only
+    static Room exportRooms[MAX_BOOKINGS];
+    int exportCount = 0;
+    JournalReader reader = {0};
+    followJournal(exportRooms, &exportCount, &reader);
+
+    long exported = exportColumnar(exportRooms, exportCount, argc > 2 ? argv[2] : EXPORT_FILE);
+    if (exported < 0)
+    {
+      printf("Error: Unable to write the export file.\n");
+      return 1;
+    }
+    printf("%ld stay(s) exported.\n", exported);
+    return 0;
+  }
+  if (argc > 1 && strcmp(argv[1], "--simulate") == 0)
+  {
+    // Overbooking what-if over the next year: --simulate [scenarios] [threads]
+    int scenarios = argc > 2 ? atoi(argv[2]) : SIM_DEFAULT_SCENARIOS;
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    return runOverbookingSimulation(scenarios > 0 ? scenarios : SIM_DEFAULT_SCENARIOS, threads);
+  }
+
+  static Room privateRooms[MAX_BOOKINGS];
+  int privateCount = 0;
+  Room *rooms = privateRooms;
+  int *roomCount = &privateCount;
+  int choice, viewCount;
+  Room *view;
+
+  if (argc > 1 && strcmp(argv[1], "--shared") == 0)
+  {
+    // Attach to the live table shared by every desk on this host (loaded by the first one)
+    if (!openSharedStore(&rooms, &roomCount))
+    {
+      printf("Error: Unable to open the shared booking store.\n");
+      return 1;
+    }
+  }
+  else
+  {
+    // Load bookings after the initial menu display, then replay changes not yet saved
+    JournalReader journal = {0};
+    followJournal(rooms, roomCount, &journal);
+  }
+  lockBookingStore();
+  rebuildCheckoutHeap(rooms, *roomCount);
+  unlockBookingStore(0);
+
+  if (argc > 2 && strcmp(argv[1], "--record") == 0 && !startTraceRecording(rooms, *roomCount, argv[2]))
+  {
+    printf("Error: Unable to create trace file %s.\n", argv[2]);
+    return 1;
+  }
+
+  while (1)
+  {
+    system("cls"); // Clear screen before showing menu
+    displayMenu();
+    choice = getValidInteger("Enter your choice: ");
+
+    switch (choice)
+    {
+    case 1:
+      addBooking(rooms, roomCount);
+      break;
+    case 2:
+      deleteBooking(rooms, roomCount);
+      break;
+    case 3:
+      view = viewBookingStore(rooms, roomCount, &viewCount);
+      displayBookings(view, viewCount);
+      break;
+    case 4:
+      view = viewBookingStore(rooms, roomCount, &viewCount);
+      searchBooking(view, viewCount);
+      break;
+    case 5:
+      modifyBooking(rooms, roomCount);
+      break;
+    case 6:
+      addGroupBooking(rooms, roomCount);
+      break;
+    case 7:
+      optimizeRoomAssignments(rooms, roomCount);
+      break;
+    case 8:
+      stayHistoryMenu(rooms, roomCount);
+      break;
+    case 9:
+      nightAudit(rooms);
+      break;
+    case 10:
+      lockBookingStore();
+      saveBookingsToFile(rooms, *roomCount);
+      unlockBookingStore(0);
+      finishTraceRecording(rooms, *roomCount);
+      closeSharedStore();
+      printf("\nThank you for using Rasa Ria Room Booking System!\n");
+      return 0;
+    default:
+      printf("\n================================================\n");
+      printf("Invalid choice. Please enter a number from 1 to 10.\n");
+      printf("================================================\n");
+    }
+    printf("\nPress Enter to continue...");
+    getchar();
+  }
+
+  return 0;
+}
+
+// Function to display the main menu
+void displayMenu()
+{
+  printf("\n\n");
+  printf("\t\t=============================================\n");
+  printf("\t\t|                                           |\n");
+  printf("\t\t|       ----------------------------        |\n");
+  printf("\t\t|            RASA RIA ROOM BOOKING          |\n");
+  printf("\t\t|       ----------------------------        |\n");
+  printf("\t\t|                                           |\n");
+  printf("\t\t=============================================\n\n");
+  printf("===== RASA RIA HOTEL SERVICES =====\n");
+  printf("1. Add New Booking\n");
+  printf("2. Cancel Booking\n");
+  printf("3. Display All Bookings\n");
+  printf("4. Search for a Booking\n");
+  printf("5. Modify Existing Booking\n");
+  printf("6. Add Group Booking\n");
+  printf("7. Optimize Room Assignments\n");
+  printf("8. Archive & Stay History\n");
+  printf("9. Night Audit (Advance Business Date)\n");
+  printf("10. Save & Exit\n");
+  printf("==================================\n");
+}
+
+// Function to clear input buffer
+void clearInputBuffer()
+{
+  int c;
+  while ((c = getchar()) != '\n' && c != EOF)
+    ;
+}
+
+// Function to get valid integer input
+int getValidInteger(const char *prompt)
+{
+  int value;
+  char line[256];
+
+  while (1)
+  {
+    printf("%s", prompt);
+    if (fgets(line, sizeof(line), stdin) == NULL)
+    {
+      continue;
+    }
+
+    if (sscanf(line, "%d", &value) == 1)
+    {
+      return value;
+    }
+
+    printf("Invalid input. Please enter a valid number.\n");
+  }
+}
+
+// Function to validate contact number 
+int validateContact(const char *contact)
+{
+  // Simple validation: must be between 8-12 digits
+  int len = strlen(contact);
+  if (len < 8 || len > 12)
+  {
+    return 0;
+  }
+  for (int i = 0; i < len; i++)
+  {
+    if (!((contact[i] >= '0' && contact[i] <= '9') || contact[i] == '-' || contact[i] == '+'))
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Function to get current date 
+void getCurrentDate(Date *date)
+{
+  printf("Enter today's date.\n");
+  printf("Day (DD): ");
+  scanf("%d", &date->day);
+  printf("Month (MM): ");
+  scanf("%d", &date->month);
+  printf("Year (YYYY): ");
+  scanf("%d", &date->year);
+}
+
+// Function to get the date end-of-day work (archive, optimizer) runs for.
+// This is the business date of the last night audit; today's date is asked for only
+// if no audit has run yet.
+void getBusinessDate(Date *date)
+{
+  lockBookingStore(); // Picks up an audit made at another desk
+  int day = businessDay;
+  unlockBookingStore(0);
+
+  if (day > 0)
+  {
+    dayNumberToDate(day, date);
+    printf("Business date: %02d/%02d/%04d\n", date->day, date->month, date->year);
+    return;
+  }
+  getCurrentDate(date);
+  clearInputBuffer();
+}
+
+// Function to validate date
+int isDateValid(Date date)
+{
+  // Basic validation
+  if (date.month < 1 || date.month > 12)
+    return 0;
+
+  int daysInMonth[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+  // Adjust for leap year
+  if (date.year % 400 == 0 || (date.year % 100 != 0 && date.year % 4 == 0))
+  {
+    daysInMonth[2] = 29;
+  }
+
+  return (date.day > 0 && date.day <= daysInMonth[date.month]);
+}
+
+// Function to calculate check-out date (simple addition, no time.h)
+void calculateCheckOutDate(Date *checkIn, Date *checkOut, int nights)
+{
+  // Just add nights to the day (no month/year handling for simplicity)
+  checkOut->day = checkIn->day + nights;
+  checkOut->month = checkIn->month;
+  checkOut->year = checkIn->year;
+}
+
+// Function to convert a date to a day number (days since 01/01/0001)
+// Days past the end of the month simply roll over, which keeps the
+// simple check-out dates from calculateCheckOutDate comparable.
+int dateToDayNumber(Date date)
+{
+  const int daysBeforeMonth[] = {0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+  if (date.month < 1 || date.month > 12)
+    return 0;
+
+  int y = date.year - 1;
+  int days = y * 365 + y / 4 - y / 100 + y / 400 + daysBeforeMonth[date.month];
+
+  // Add the leap day once February is over
+  if (date.month > 2 && (date.year % 400 == 0 || (date.year % 100 != 0 && date.year % 4 == 0)))
+  {
+    days++;
+  }
+
+  return days + date.day - 1;
+}
+
+// Function to convert a day number back to a normal calendar date
+void dayNumberToDate(int dayNumber, Date *date)
+{
+  Date start = {1, 1, dayNumber / 366 + 1};
+
+  while (1)
+  {
+    Date nextYear = {1, 1, start.year + 1};
+    if (dateToDayNumber(nextYear) > dayNumber)
+      break;
+    start.year++;
+  }
+
+  while (start.month < 12)
+  {
+    Date nextMonth = {1, start.month + 1, start.year};
+    if (dateToDayNumber(nextMonth) > dayNumber)
+      break;
+    start.month++;
+  }
+
+  start.day = dayNumber - dateToDayNumber(start) + 1;
+  *date = start;
+}
+
+// Function to get room type name string
+const char *getRoomTypeName(RoomType type)
+{
+  if (!isValidRoomType(type))
+    return "Unknown";
+  return inventory.types[type].name;
+}
+
+// Function to read a check-in date from today up to 1 year in the future
+void readCheckInDate(Date *checkIn)
+{
+  Date today;
+  getCurrentDate(&today);
+  printf("Today is: %02d/%02d/%04d\n", today.day, today.month, today.year);
+
+  // Allow booking starting from today up to 1 year in the future
+  do
+  {
+    printf("Enter check-in day (DD): ");
+    scanf("%d", &checkIn->day);
+    printf("Enter check-in month (MM): ");
+    scanf("%d", &checkIn->month);
+    printf("Enter check-in year (YYYY): ");
+    scanf("%d", &checkIn->year);
+
+    // Basic validation: check if date is valid and not in the past
+    if (!isDateValid(*checkIn))
+    {
+      printf("Invalid date. Please enter a valid date.\n");
+      continue;
+    }
+
+    // Compare check-in date with today's date
+    if (checkIn->year < today.year ||
+        (checkIn->year == today.year &&
+         checkIn->month < today.month) ||
+        (checkIn->year == today.year &&
+         checkIn->month == today.month &&
+         checkIn->day < today.day))
+    {
+      printf("Check-in date cannot be in the past. Please enter a valid date.\n");
+      continue;
+    }
+
+    // Check if date is more than a year into the future
+    if (checkIn->year > today.year + 1 ||
+        (checkIn->year == today.year + 1 &&
+         checkIn->month > today.month) ||
+        (checkIn->year == today.year + 1 &&
+         checkIn->month == today.month &&
+         checkIn->day > today.day))
+    {
+      printf("Cannot book more than one year in advance. Please enter a valid date.\n");
+      continue;
+    }
+
+    break;
+  } while (1);
+}
+
+// Function to add a room booking
+void addBooking(Room rooms[], int *roomCount)
+{
+  if (*roomCount >= MAX_BOOKINGS)
+  {
+    printf("\n=============================================\n");
+    printf("No more rooms can be booked. Hotel is full!\n");
+    printf("=============================================\n");
+    return;
+  }
+
+  Room newBooking;
+  int roomTypeInput, nightsInput;
+
+  printf("\n=== ADDING NEW BOOKING ===\n");
+
+  printf("Enter guest name      : ");
+  clearInputBuffer(); // Clear any previous input
+  fgets(newBooking.guestName, sizeof(newBooking.guestName), stdin);
+  newBooking.guestName[strcspn(newBooking.guestName, "\n")] = '\0'; // Remove newline
+
+  do
+  {
+    printf("Enter contact number(8-12 digits) : ");
+    fgets(newBooking.contact, sizeof(newBooking.contact), stdin);
+    newBooking.contact[strcspn(newBooking.contact, "\n")] = '\0'; // Remove newline
+    if (!validateContact(newBooking.contact))
+    {
+      printf("Invalid contact number. Please enter 8-12 digits with optional +/- symbols.\n");
+    }
+  } while (!validateContact(newBooking.contact));
+
+  printRoomTypes();
+
+  printf("Enter room type (1-%d): ", inventory.typeCount);
+  if (scanf("%d", &roomTypeInput) != 1 || !isValidRoomType(roomTypeInput))
+  {
+    printf("===================================\n");
+    printf("Invalid input. Please enter a valid room type (1-%d).\n", inventory.typeCount);
+    printf("===================================\n");
+    while (getchar() != '\n')
+      ; // Clear the input buffer
+    return;
+  }
+  newBooking.roomType = roomTypeInput;
+
+  // Room features are only asked for when the inventory has any
+  unsigned int mustHave = 0, prefer = 0;
+  if (inventory.attributesUsed != 0)
+  {
+    clearInputBuffer();
+    mustHave = readRoomAttributes("Must have (e.g. seaview, accessible - Enter for none): ");
+    prefer = readRoomAttributes("Would prefer (Enter for none): ");
+  }
+
+  printf("Enter number of nights(1-30): ");
+  if (scanf("%d", &nightsInput) != 1 || nightsInput <= 0 || nightsInput > 30)
+  {
+    printf("===================================\n");
+    printf("Invalid input. Please enter a positive number of nights.\n");
+    printf("===================================\n");
+    while (getchar() != '\n')
+      ; // Clear the input buffer
+    return;
+  }
+  newBooking.nights = nightsInput;
+
+  // Get check-in date
+  printf("\nCheck-in Date:\n");
+  readCheckInDate(&newBooking.checkInDate);
+
+  // Calculate check-out date
+  calculateCheckOutDate(&newBooking.checkInDate, &newBooking.checkOutDate, newBooking.nights);
+
+  // Calculate total price based on room type and number of nights
+  newBooking.totalPrice = getRoomTypeRate(newBooking.roomType) * newBooking.nights;
+
+  // Assign a room number - the store is locked from here until the booking is committed
+  lockBookingStore();
+  newBooking.roomNumber = *roomCount < MAX_BOOKINGS
+                              ? assignMatchingRoom(rooms, *roomCount, newBooking.roomType, newBooking.checkInDate,
+                                                   newBooking.nights, -1, mustHave, prefer)
+                              : -1;
+  if (newBooking.roomNumber == -1)
+  {
+    unlockBookingStore(0);
+    printf("\n==============================================\n");
+    printf("No available room of the selected type. Sorry!\n");
+    printf("==============================================\n");
+    clearInputBuffer();
+    return;
+  }
+
+  newBooking.isBooked = 1;
+  newBooking.bookingId = nextBookingId++;
+  insertBooking(rooms, roomCount, &newBooking, mustHave, prefer);
+  unlockBookingStore(1);
+
+  clearInputBuffer();
+
+  printf("\n===========================================================\n");
+  printf("Booking added successfully!\n");
+  printf("Room number assigned: %d\n", newBooking.roomNumber);
+  printf("Check-in date: %02d/%02d/%04d\n",
+         newBooking.checkInDate.day, newBooking.checkInDate.month, newBooking.checkInDate.year);
+  printf("Check-out date: %02d/%02d/%04d\n",
+         newBooking.checkOutDate.day, newBooking.checkOutDate.month, newBooking.checkOutDate.year);
+  printf("Total price: $%.2f\n", newBooking.totalPrice);
+  printf("===========================================================\n");
+}
+
+// Function to set up the built-in inventory: 20 suites, 40 doubles and 40 singles on three floors
+void useDefaultInventory()
+{
+  static InventoryRoom list[MAX_ROOMS];
+  int count = 0;
+
+  inventory.typeCount = 3;
+  strcpy(inventory.types[1].name, "Suite");
+  inventory.types[1].rate = 1000.0f;
+  strcpy(inventory.types[2].name, "Double");
+  inventory.types[2].rate = 600.0f;
+  strcpy(inventory.types[3].name, "Single");
+  inventory.types[3].rate = 400.0f;
+
+  addInventoryRooms(list, &count, 1, 20, 1, 1, 0);
+  addInventoryRooms(list, &count, 21, 60, 2, 2, 0);
+  addInventoryRooms(list, &count, 61, 100, 3, 3, 0);
+  indexRoomInventory(list, count);
+}
+
+// Function to add rooms firstNumber..lastNumber to an inventory list, returns 0 if they do not fit
+int addInventoryRooms(InventoryRoom list[], int *count, int firstNumber, int lastNumber, RoomType type,
+                      int floor, unsigned int attributes)
+{
+  if (firstNumber < 1 || lastNumber > MAX_ROOM_NUMBER || firstNumber > lastNumber ||
+      *count + (lastNumber - firstNumber + 1) > MAX_ROOMS)
+    return 0;
+
+  for (int number = firstNumber; number <= lastNumber; number++)
+  {
+    list[*count].number = number;
+    list[*count].type = type;
+    list[*count].floor = floor;
+    list[*count].attributes = attributes;
+    (*count)++;
+  }
+  return 1;
+}
+
+// Comparison function for ordering the room table by type, attribute set, then room number
+int compareInventoryRoom(const void *a, const void *b)
+{
+  const InventoryRoom *x = (const InventoryRoom *)a;
+  const InventoryRoom *y = (const InventoryRoom *)b;
+  if (x->type != y->type)
+    return (x->type > y->type) - (x->type < y->type);
+  if (x->attributes != y->attributes)
+    return (x->attributes > y->attributes) - (x->attributes < y->attributes);
+  return (x->number > y->number) - (x->number < y->number);
+}
+
+// Function to build the room table from a list of rooms.
+// Grouping plain rooms first means requests without attributes leave special rooms for guests who need them.
+void indexRoomInventory(InventoryRoom list[], int count)
+{
+  qsort(list, count, sizeof(InventoryRoom), compareInventoryRoom);
+
+  for (int n = 0; n <= MAX_ROOM_NUMBER; n++)
+    inventory.slotOfRoom[n] = -1;
+  for (int t = 1; t <= inventory.typeCount; t++)
+  {
+    inventory.types[t].first = 0;
+    inventory.types[t].count = 0;
+  }
+
+  inventory.roomCount = count;
+  inventory.highestRoom = 0;
+  inventory.attributesUsed = 0;
+  for (int k = 0; k < count; k++)
+  {
+    inventory.roomNumber[k] = list[k].number;
+    inventory.floor[k] = list[k].floor;
+    inventory.attributes[k] = list[k].attributes;
+    inventory.slotOfRoom[list[k].number] = (short)k;
+    if (list[k].number > inventory.highestRoom)
+      inventory.highestRoom = list[k].number;
+    inventory.attributesUsed |= list[k].attributes;
+
+    RoomTypeInfo *type = &inventory.types[list[k].type];
+    if (type->count++ == 0)
+      type->first = k;
+  }
+}
+
+// Function to load the room inventory from a config file.
+//
+// One entry per line, '#' starts a comment:
+//   type <name> <rate per night>
+//   rooms <first>-<last> <type name> floor <n> [seaview] [accessible] [connecting] [smoking]
+// Types are numbered in the order they are listed and bookings store that number,
+// so new types must be added at the end (checkRoomTypeNames enforces this).
+// Returns 1 if the file was loaded, 0 if there is no file (the built-in inventory is used),
+// or -1 if the file has an error - the hotel must not run on a different set of rooms by accident.
+int loadRoomInventory(const char *path)
+{
+  static InventoryRoom list[MAX_ROOMS];
+  char line[CONFIG_LINE_LENGTH];
+  int count = 0, lineNumber = 0;
+
+  FILE *file = fopen(path, "r");
+  if (file == NULL)
+  {
+    useDefaultInventory();
+    return 0;
+  }
+
+  inventory.typeCount = 0;
+  while (fgets(line, sizeof(line), file) != NULL)
+  {
+    char keyword[16], name[MAX_TYPE_NAME], floorWord[16];
+    int first, last, floor, consumed = 0, ok = 1;
+    float rate;
+
+    lineNumber++;
+    line[strcspn(line, "#\r\n")] = '\0'; // Remove comment and newline
+    if (sscanf(line, "%15s", keyword) != 1)
+      continue;
+
+    if (strcmp(keyword, "type") == 0)
+    {
+      ok = inventory.typeCount < MAX_ROOM_TYPES && sscanf(line, "type %15s %f", name, &rate) == 2 && rate >= 0;
+      for (int t = 1; ok && t <= inventory.typeCount; t++)
+      {
+        // Types are looked up by name, so a second one of the same name could never be booked
+        if (equalsIgnoreCase(name, inventory.types[t].name))
+        {
+          printf("%s line %d lists room type %s more than once.\n", path, lineNumber, name);
+          fclose(file);
+          return -1;
+        }
+      }
+      if (ok)
+      {
+        inventory.typeCount++;
+        strcpy(inventory.types[inventory.typeCount].name, name);
+        inventory.types[inventory.typeCount].rate = rate;
+      }
+    }
+    else if (strcmp(keyword, "rooms") == 0)
+    {
+      unsigned int attributes = 0;
+      RoomType type = 0;
+      ok = sscanf(line, "rooms %d-%d %15s %15s %d %n", &first, &last, name, floorWord, &floor, &consumed) == 5 &&
+           consumed > 0 && strcmp(floorWord, "floor") == 0 && parseRoomAttributes(line + consumed, &attributes);
+      for (int t = 1; ok && t <= inventory.typeCount; t++)
+      {
+        if (equalsIgnoreCase(name, inventory.types[t].name))
+          type = t;
+      }
+      ok = ok && type != 0 && addInventoryRooms(list, &count, first, last, type, floor, attributes);
+    }
+    else
+    {
+      ok = 0;
+    }
+
+    if (!ok)
+    {
+      printf("%s line %d is not valid: %s\n", path, lineNumber, line);
+      fclose(file);
+      return -1;
+    }
+  }
+  fclose(file);
+
+  // Every room number may appear only once
+  for (int n = 0; n <= MAX_ROOM_NUMBER; n++)
+    inventory.slotOfRoom[n] = -1;
+  for (int k = 0; k < count; k++)
+  {
+    if (inventory.slotOfRoom[list[k].number] != -1)
+    {
+      printf("%s lists room %d more than once.\n", path, list[k].number);
+      return -1;
+    }
+    inventory.slotOfRoom[list[k].number] = 0;
+  }
+
+  if (inventory.typeCount == 0 || count == 0)
+  {
+    printf("%s has no room types or rooms.\n", path);
+    return -1;
+  }
+
+  indexRoomInventory(list, count);
+  return 1;
+}
+
+// Function to check the inventory's room types against the type names the saved bookings use.
+// Bookings store a type's number, so reordering the types in the config would silently re-type them.
+// The file is created, or extended when types are added at the end. Returns 1 if the types match.
+int checkRoomTypeNames(const char *path)
+{
+  char line[CONFIG_LINE_LENGTH], name[MAX_TYPE_NAME];
+  int type, savedCount = 0;
+
+  FILE *file = fopen(path, "r");
+  if (file != NULL)
+  {
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+      if (sscanf(line, "%d %15s", &type, name) != 2)
+        continue;
+      if (type < 1 || type > inventory.typeCount)
+      {
+        printf("Saved bookings use room type %d (%s), but the room inventory has only %d type(s).\n", type, name,
+               inventory.typeCount);
+        fclose(file);
+        return 0;
+      }
+      if (!equalsIgnoreCase(name, inventory.types[type].name))
+      {
+        printf("Saved bookings use room type %d for %s, but the room inventory lists %s there.\n", type, name,
+               inventory.types[type].name);
+        fclose(file);
+        return 0;
+      }
+      if (type > savedCount)
+        savedCount = type;
+    }
+    fclose(file);
+  }
+
+  if (savedCount < inventory.typeCount)
+  {
+    file = fopen(path, "w");
+    if (file == NULL)
+    {
+      printf("Warning: Unable to write %s.\n", path);
+      return 1;
+    }
+    for (int t = 1; t <= inventory.typeCount; t++)
+      fprintf(file, "%d %s\n", t, inventory.types[t].name);
+    fclose(file);
+  }
+  return 1;
+}
+
+// Function to check that a number is one of the inventory's room types
+int isValidRoomType(int type)
+{
+  return type >= 1 && type <= inventory.typeCount;
+}
+
+// Function to get the nightly rate of a room type (0 for an unknown type)
+float getRoomTypeRate(RoomType type)
+{
+  return isValidRoomType(type) ? inventory.types[type].rate : 0.0f;
+}
+
+// Function to find a room's slot in the room table, -1 if the inventory has no such room
+int roomSlot(int roomNumber)
+{
+  if (roomNumber < 1 || roomNumber > MAX_ROOM_NUMBER)
+    return -1;
+  return inventory.slotOfRoom[roomNumber];
+}
+
+// Function to get the attribute mask of a room (0 if the inventory has no such room)
+unsigned int roomAttributes(int roomNumber)
+{
+  int slot = roomSlot(roomNumber);
+  return slot == -1 ? 0 : inventory.attributes[slot];
+}
+
+// Function to read attribute names (separated by spaces or commas) into a mask.
+// Returns 0 if a name is not known.
+int parseRoomAttributes(const char *text, unsigned int *attributes)
+{
+  char word[CONFIG_LINE_LENGTH];
+  int consumed;
+
+  *attributes = 0;
+  while (sscanf(text, " %[^, \t\n]%n", word, &consumed) == 1)
+  {
+    int bit = -1;
+    for (int a = 0; a < ATTR_COUNT; a++)
+    {
+      if (equalsIgnoreCase(word, ATTRIBUTE_NAMES[a]))
+        bit = a;
+    }
+    if (bit == -1)
+      return 0;
+    *attributes |= 1u << bit;
+
+    text += consumed;
+    while (*text == ',' || *text == ' ' || *text == '\t')
+      text++;
+  }
+  return 1;
+}
+
+// Function to write an attribute mask as a list of names ("-" for none)
+void formatRoomAttributes(unsigned int attributes, char *buf, int size)
+{
+  int length = 0;
+
+  buf[0] = '\0';
+  for (int a = 0; a < ATTR_COUNT && length < size; a++)
+  {
+    if (attributes & (1u << a))
+      length += snprintf(buf + length, size - length, "%s%s", length > 0 ? ", " : "", ATTRIBUTE_NAMES[a]);
+  }
+  if (length == 0)
+    snprintf(buf, size, "-");
+}
+
+// Function to count the set bits of a mask
+int countBits(unsigned int value)
+{
+  int count = 0;
+  for (; value != 0; value &= value - 1)
+    count++;
+  return count;
+}
+
+// Comparison function for sorting room numbers
+int compareRoomNumber(const void *a, const void *b)
+{
+  int x = *(const int *)a;
+  int y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+// Function to list the room types and their rates
+void printRoomTypes()
+{
+  printf("Room Types:\n");
+  for (int t = 1; t <= inventory.typeCount; t++)
+  {
+    printf("%d. %-8s - RM%.2f per night\n", t, inventory.types[t].name, inventory.types[t].rate);
+  }
+}
+
+// Function to ask for a set of room attributes (Enter for none)
+unsigned int readRoomAttributes(const char *prompt)
+{
+  char text[CONFIG_LINE_LENGTH];
+  unsigned int attributes;
+
+  while (1)
+  {
+    printf("%s", prompt);
+    if (fgets(text, sizeof(text), stdin) == NULL)
+      return 0;
+    if (parseRoomAttributes(text, &attributes))
+      return attributes;
+    printf("Unknown attribute. Use seaview, accessible, connecting or smoking.\n");
+  }
+}
+
+// Function to build the availability index for a stay: one pass over the bookings
+// marks every room number that is taken for at least one night of the stay.
+// The booking at skipIndex is ignored so a booking can be moved onto its own nights.
+void markOccupiedRooms(Room rooms[], int roomCount, Date checkIn, int nights, int skipIndex,
+                       unsigned char occupied[])
+{
+  int firstNight = dateToDayNumber(checkIn);
+  int lastNight = firstNight + nights; // exclusive
+
+  // Only room numbers up to the highest one in the inventory are ever looked at
+  memset(occupied, 0, inventory.highestRoom + 1);
+  for (int j = 0; j < roomCount; j++)
+  {
+    if (j == skipIndex || !rooms[j].isBooked)
+      continue;
+    if (rooms[j].roomNumber < 1 || rooms[j].roomNumber > inventory.highestRoom)
+      continue;
+
+    int otherIn = dateToDayNumber(rooms[j].checkInDate);
+    if (otherIn < lastNight && firstNight < otherIn + rooms[j].nights)
+      occupied[rooms[j].roomNumber] = 1;
+  }
+}
+
+// Function to check if one room is free for every night of a stay
+int isRoomFree(Room rooms[], int roomCount, int roomNumber, Date checkIn, int nights, int skipIndex)
+{
+  unsigned char occupied[MAX_ROOM_NUMBER + 1];
+  if (roomSlot(roomNumber) == -1)
+    return 0;
+  markOccupiedRooms(rooms, roomCount, checkIn, nights, skipIndex, occupied);
+  return !occupied[roomNumber];
+}
+
+// Function to pick the best room of a type that is not marked in occupied[] (indexed by room number).
+// Only rooms with every mustHave attribute qualify; among those the room with the most prefer
+// attributes wins, and ties go to the first room in the table. freeRooms, if not NULL, receives
+// the number of qualifying rooms. Returns -1 if none is free.
+int pickFreeRoom(RoomType roomType, const unsigned char occupied[], unsigned int mustHave, unsigned int prefer,
+                 int *freeRooms)
+{
+  int best = -1, bestScore = -1, count = 0;
+
+  // One pass over the type's slice of the packed attribute array
+  int first = inventory.types[roomType].first;
+  int last = first + inventory.types[roomType].count;
+  for (int k = first; k < last; k++)
+  {
+    unsigned int attributes = inventory.attributes[k];
+    if ((attributes & mustHave) != mustHave || occupied[inventory.roomNumber[k]])
+      continue;
+
+    count++;
+    int score = prefer != 0 ? countBits(attributes & prefer) : 0;
+    if (score > bestScore)
+    {
+      best = inventory.roomNumber[k];
+      bestScore = score;
+      if (freeRooms == NULL && (prefer == 0 || score == countBits(prefer)))
+        break; // Nothing can beat this room
+    }
+  }
+
+  if (freeRooms != NULL)
+    *freeRooms = count;
+  return best;
+}
+
+// Function to find the best free room of a type for a stay, and optionally count the free rooms.
+// The choice is made by pickFreeRoom over the rooms booked for any night of the stay.
+int findFreeRoom(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights, int skipIndex,
+                 unsigned int mustHave, unsigned int prefer, int *freeRooms)
+{
+  unsigned char occupied[MAX_ROOM_NUMBER + 1];
+
+  if (freeRooms != NULL)
+    *freeRooms = 0;
+  if (!isValidRoomType(roomType))
+    return -1; // Invalid room type
+
+  markOccupiedRooms(rooms, roomCount, checkIn, nights, skipIndex, occupied);
+  return pickFreeRoom(roomType, occupied, mustHave, prefer, freeRooms); // -1 if no available room found
+}
+
+// Function to assign room number based on room type and stay dates
+int assignRoomNumber(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights, int skipIndex)
+{
+  return assignMatchingRoom(rooms, roomCount, roomType, checkIn, nights, skipIndex, 0, 0);
+}
+
+// Function to assign a room with the requested attributes.
+// New stays go through the availability cache; moving an existing booking (skipIndex >= 0)
+// is answered directly because the booking's own nights must be ignored.
+int assignMatchingRoom(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights, int skipIndex,
+                       unsigned int mustHave, unsigned int prefer)
+{
+  if (skipIndex == -1)
+    return quoteAvailability(rooms, roomCount, roomType, checkIn, nights, mustHave, prefer, NULL);
+  return findFreeRoom(rooms, roomCount, roomType, checkIn, nights, skipIndex, mustHave, prefer, NULL);
+}
+
+// Function to mark every cached availability answer for a room type as stale
+void invalidateAvailability(RoomType roomType)
+{
+  if (isValidRoomType(roomType))
+    availabilityEpoch[roomType]++;
+  bookingsVersion++;
+}
+
+// Function to mark every cached availability answer as stale (bulk reloads and removals)
+void invalidateAllAvailability()
+{
+  for (int type = 1; type <= inventory.typeCount; type++)
+    availabilityEpoch[type]++;
+  bookingsVersion++;
+}
+
+// Function to answer an availability question through the cache.
+// Returns the room a new stay would get (-1 if none) and the number of free rooms.
+int quoteAvailability(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights,
+                      unsigned int mustHave, unsigned int prefer, int *freeRooms)
+{
+  if (!isValidRoomType(roomType))
+  {
+    if (freeRooms != NULL)
+      *freeRooms = 0;
+    return -1;
+  }
+
+  int checkInDay = dateToDayNumber(checkIn);
+  int checkOutDay = checkInDay + nights;
+  unsigned int hash = (unsigned int)roomType * 2654435761u ^ (unsigned int)checkInDay * 40503u ^
+                      (unsigned int)checkOutDay * 2246822519u ^ (mustHave << 8 | prefer) * 3266489917u;
+  AvailabilityCacheEntry *entry = &availabilityCache[(hash ^ (hash >> 15)) & (AVAILABILITY_CACHE_SLOTS - 1)];
+
+  if (entry->roomType == roomType && entry->checkIn == checkInDay && entry->checkOut == checkOutDay &&
+      entry->mustHave == mustHave && entry->prefer == prefer && entry->epoch == availabilityEpoch[roomType])
+  {
+    availabilityHits++;
+  }
+  else
+  {
+    availabilityMisses++;
+    entry->roomType = roomType;
+    entry->checkIn = checkInDay;
+    entry->checkOut = checkOutDay;
+    entry->mustHave = mustHave;
+    entry->prefer = prefer;
+    entry->epoch = availabilityEpoch[roomType];
+    entry->roomNumber = findFreeRoom(rooms, roomCount, roomType, checkIn, nights, -1, mustHave, prefer,
+                                     &entry->freeRooms);
+  }
+
+  if (freeRooms != NULL)
+    *freeRooms = entry->freeRooms;
+  return entry->roomNumber;
+}
+
+// Function to quote availability for a room type and dates without booking
+void checkAvailability(Room rooms[], int roomCount)
+{
+  Date checkIn;
+  unsigned int mustHave = 0, prefer = 0;
+
+  printf("\n=== CHECK AVAILABILITY ===\n");
+  printRoomTypes();
+  char prompt[64];
+  snprintf(prompt, sizeof(prompt), "Enter room type (1-%d): ", inventory.typeCount);
+  int roomType = getValidInteger(prompt);
+  if (!isValidRoomType(roomType))
+  {
+    printf("Invalid input. Please enter a valid room type (1-%d).\n", inventory.typeCount);
+    return;
+  }
+  if (inventory.attributesUsed != 0)
+  {
+    mustHave = readRoomAttributes("Must have (e.g. seaview, accessible - Enter for none): ");
+    prefer = readRoomAttributes("Would prefer (Enter for none): ");
+  }
+  int nights = getValidInteger("Enter number of nights(1-30): ");
+  if (nights <= 0 || nights > 30)
+  {
+    printf("Invalid input. Please enter a positive number of nights.\n");
+    return;
+  }
+
+  printf("\nCheck-in Date:\n");
+  readCheckInDate(&checkIn);
+  clearInputBuffer();
+
+  int freeRooms;
+  int roomNumber = quoteAvailability(rooms, roomCount, roomType, checkIn, nights, mustHave, prefer, &freeRooms);
+
+  printf("\n====================================================\n");
+  if (roomNumber == -1)
+    printf("No %s room is free for those dates.\n", getRoomTypeName(roomType));
+  else
+  {
+    char features[64];
+    formatRoomAttributes(roomAttributes(roomNumber), features, sizeof(features));
+    printf("%d %s room(s) free - a booking now would get room %d (floor %d, %s).\n",
+           freeRooms, getRoomTypeName(roomType), roomNumber, inventory.floor[roomSlot(roomNumber)], features);
+  }
+  printf("Price: $%.2f\n", getRoomTypeRate(roomType) * nights);
+  printf("Availability cache: %ld hit(s), %ld miss(es)\n", availabilityHits, availabilityMisses);
+  printf("====================================================\n");
+}
+
+// Function to pick roomsNeeded free rooms of one type for a stay, as close together as possible.
+// Only rooms with every mustHave attribute qualify (group bookings take no preferences).
+// The chosen rooms span the fewest room numbers (a contiguous block when one exists);
+// ties go to the block inside the smallest free run, so large runs stay intact.
+// Returns 1 and fills roomNumbers[] on success, 0 if not enough rooms are free.
+int findGroupRoomBlock(Room rooms[], int roomCount, RoomType roomType, Date checkIn, int nights,
+                       int roomsNeeded, unsigned int mustHave, int roomNumbers[])
+{
+  unsigned char occupied[MAX_ROOM_NUMBER + 1];
+  int freeRooms[MAX_ROOMS];
+  int runLength[MAX_ROOMS]; // Length of the free run each free room belongs to
+  int freeCount = 0;
+
+  if (roomsNeeded < 1 || !isValidRoomType(roomType))
+    return 0;
+
+  markOccupiedRooms(rooms, roomCount, checkIn, nights, -1, occupied);
+
+  int first = inventory.types[roomType].first;
+  for (int k = first; k < first + inventory.types[roomType].count; k++)
+  {
+    if ((inventory.attributes[k] & mustHave) == mustHave && !occupied[inventory.roomNumber[k]])
+      freeRooms[freeCount++] = inventory.roomNumber[k];
+  }
+  if (freeCount < roomsNeeded)
+    return 0;
+  qsort(freeRooms, freeCount, sizeof(int), compareRoomNumber); // The table is grouped by attributes first
+
+  for (int i = 0; i < freeCount;)
+  {
+    int j = i;
+    while (j + 1 < freeCount && freeRooms[j + 1] == freeRooms[j] + 1)
+      j++;
+    for (int k = i; k <= j; k++)
+      runLength[k] = j - i + 1;
+    i = j + 1;
+  }
+
+  int best = -1, bestSpan = 0, bestRun = 0;
+  for (int i = 0; i + roomsNeeded <= freeCount; i++)
+  {
+    int span = freeRooms[i + roomsNeeded - 1] - freeRooms[i];
+    int run = runLength[i];
+    if (best == -1 || span < bestSpan || (span == bestSpan && run < bestRun))
+    {
+      best = i;
+      bestSpan = span;
+      bestRun = run;
+    }
+  }
+
+  for (int k = 0; k < roomsNeeded; k++)
+    roomNumbers[k] = freeRooms[best + k];
+  return 1;
+}
+
+// Function to book roomsNeeded rooms for one stay in a single step.
+// Either every room of the block is booked or none is (nothing changes on failure).
+// Returns 1 and fills roomNumbers[] on success, 0 if the group cannot be placed.
+int bookRoomBlock(Room rooms[], int *roomCount, const Room *booking, int roomsNeeded, unsigned int mustHave,
+                  int roomNumbers[])
+{
+  if (*roomCount + roomsNeeded > MAX_BOOKINGS)
+    return 0;
+
+  if (!findGroupRoomBlock(rooms, *roomCount, booking->roomType, booking->checkInDate,
+                          booking->nights, roomsNeeded, mustHave, roomNumbers))
+    return 0;
+
+  // The adds are journaled between "[ firstId count" and "] firstId", so a reader applies
+  // the group only once all of it is on disk
+  char line[2 * JOURNAL_LINE_LENGTH];
+  int firstId = nextBookingId;
+  snprintf(line, sizeof(line), "[ %d %d", firstId, roomsNeeded);
+  writeJournalLine(line);
+  for (int k = 0; k < roomsNeeded; k++)
+  {
+    rooms[*roomCount + k] = *booking;
+    rooms[*roomCount + k].bookingId = nextBookingId++;
+    rooms[*roomCount + k].roomNumber = roomNumbers[k];
+    rooms[*roomCount + k].isBooked = 1;
+    formatJournalEntry('A', NULL, &rooms[*roomCount + k], line, sizeof(line));
+    writeJournalLine(line);
+    trackCheckout(rooms, *roomCount + k);
+  }
+  snprintf(line, sizeof(line), "] %d", firstId);
+  writeJournalLine(line);
+  invalidateAvailability(booking->roomType);
+
+  // The session trace keeps the group as one request, so a replay places the block again
+  char record[JOURNAL_LINE_LENGTH];
+  formatJournalRecord(&rooms[*roomCount], record, sizeof(record));
+  snprintf(line, sizeof(line), "G %d %u %s", roomsNeeded, mustHave, record);
+  recordTrace(line);
+
+  *roomCount += roomsNeeded;
+  return 1;
+}
+
+// Function to commit a new booking (its id and room already assigned) to the store.
+// mustHave and prefer are the features the room was chosen for; only the session trace keeps them.
+void insertBooking(Room rooms[], int *roomCount, const Room *booking, unsigned int mustHave, unsigned int prefer)
+{
+  char line[2 * JOURNAL_LINE_LENGTH], record[JOURNAL_LINE_LENGTH];
+
+  rooms[*roomCount] = *booking;
+  (*roomCount)++;
+  if (formatJournalEntry('A', NULL, booking, line, sizeof(line)))
+    writeJournalLine(line);
+  invalidateAvailability(booking->roomType);
+  trackCheckout(rooms, *roomCount - 1);
+
+  // The trace keeps the request, so a replay asks the allocator the same question
+  formatJournalRecord(booking, record, sizeof(record));
+  snprintf(line, sizeof(line), "A %d %u %u %s", booking->bookingId, mustHave, prefer, record);
+  recordTrace(line);
+}
+
+// Function to replace the booking at index with its changed version
+void updateBookingAt(Room rooms[], int index, const Room *updated)
+{
+  Room before = rooms[index];
+  rooms[index] = *updated;
+  appendJournal('M', &before, &rooms[index]);
+  trackCheckout(rooms, index);
+}
+
+// Function to cancel the booking at index and close the gap it leaves
+void cancelBookingAt(Room rooms[], int *roomCount, int index)
+{
+  appendJournal('C', &rooms[index], NULL);
+  for (int i = index; i < *roomCount - 1; i++)
+  {
+    rooms[i] = rooms[i + 1];
+  }
+  (*roomCount)--;
+  rebuildCheckoutHeap(rooms, *roomCount);
+}
+
+// Function to add a group booking (several rooms of one type for the same dates)
+void addGroupBooking(Room rooms[], int *roomCount)
+{
+  Room groupBooking;
+  int roomNumbers[MAX_ROOMS];
+
+  printf("\n=== ADDING GROUP BOOKING ===\n");
+
+  printf("Enter group / guest name : ");
+  fgets(groupBooking.guestName, sizeof(groupBooking.guestName), stdin);
+  groupBooking.guestName[strcspn(groupBooking.guestName, "\n")] = '\0'; // Remove newline
+
+  do
+  {
+    printf("Enter contact number(8-12 digits) : ");
+    fgets(groupBooking.contact, sizeof(groupBooking.contact), stdin);
+    groupBooking.contact[strcspn(groupBooking.contact, "\n")] = '\0'; // Remove newline
+    if (!validateContact(groupBooking.contact))
+    {
+      printf("Invalid contact number. Please enter 8-12 digits with optional +/- symbols.\n");
+    }
+  } while (!validateContact(groupBooking.contact));
+
+  printRoomTypes();
+
+  char prompt[64];
+  snprintf(prompt, sizeof(prompt), "Enter room type (1-%d): ", inventory.typeCount);
+  int roomTypeInput = getValidInteger(prompt);
+  if (!isValidRoomType(roomTypeInput))
+  {
+    printf("Invalid input. Please enter a valid room type (1-%d).\n", inventory.typeCount);
+    return;
+  }
+  groupBooking.roomType = roomTypeInput;
+
+  // Every room of the block must have the must-have features
+  unsigned int mustHave = 0;
+  if (inventory.attributesUsed != 0)
+    mustHave = readRoomAttributes("Must have for every room (e.g. seaview - Enter for none): ");
+
+  int typeRooms = inventory.types[groupBooking.roomType].count;
+  int roomsNeeded = getValidInteger("Enter number of rooms: ");
+  if (roomsNeeded < 1 || roomsNeeded > typeRooms)
+  {
+    printf("Invalid input. There are only %d %s rooms.\n", typeRooms, getRoomTypeName(groupBooking.roomType));
+    return;
+  }
+
+  groupBooking.nights = getValidInteger("Enter number of nights(1-30): ");
+  if (groupBooking.nights <= 0 || groupBooking.nights > 30)
+  {
+    printf("Invalid input. Please enter a positive number of nights.\n");
+    return;
+  }
+
+  printf("\nCheck-in Date:\n");
+  readCheckInDate(&groupBooking.checkInDate);
+  clearInputBuffer();
+
+  calculateCheckOutDate(&groupBooking.checkInDate, &groupBooking.checkOutDate, groupBooking.nights);
+  groupBooking.totalPrice = getRoomTypeRate(groupBooking.roomType) * groupBooking.nights;
+
+  lockBookingStore();
+  int booked = bookRoomBlock(rooms, roomCount, &groupBooking, roomsNeeded, mustHave, roomNumbers);
+  unlockBookingStore(booked);
+  if (!booked)
+  {
+    printf("\n==========================================================\n");
+    printf("Not enough %s rooms%s free for these dates. Nothing booked.\n", getRoomTypeName(groupBooking.roomType),
+           mustHave != 0 ? " with those features" : "");
+    printf("==========================================================\n");
+    return;
+  }
+
+  printf("\n===========================================================\n");
+  printf("Group booking added successfully!\n");
+  printf("Rooms assigned:");
+  for (int k = 0; k < roomsNeeded; k++)
+  {
+    printf(" %d", roomNumbers[k]);
+  }
+  printf("\n");
+  printf("Check-in date: %02d/%02d/%04d\n",
+         groupBooking.checkInDate.day, groupBooking.checkInDate.month, groupBooking.checkInDate.year);
+  printf("Check-out date: %02d/%02d/%04d\n",
+         groupBooking.checkOutDate.day, groupBooking.checkOutDate.month, groupBooking.checkOutDate.year);
+  printf("Total price: $%.2f (%d rooms)\n", groupBooking.totalPrice * roomsNeeded, roomsNeeded);
+  printf("===========================================================\n");
+}
+
+// Function to find the booking for a room number.
+// A room can be booked for several stays, so the clerk picks one when there is more than one.
+// Returns the booking index, or -1 if the room has no booking.
+int findBookingByRoom(Room rooms[], int roomCount, int roomNumber)
+{
+  int matches = 0, index = -1;
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    if (rooms[i].roomNumber == roomNumber && rooms[i].isBooked)
+    {
+      matches++;
+      index = i;
+    }
+  }
+  if (matches <= 1)
+    return index;
+
+  printf("\nRoom %d has %d bookings:\n", roomNumber, matches);
+  int n = 0;
+  for (int i = 0; i < roomCount; i++)
+  {
+    if (rooms[i].roomNumber == roomNumber && rooms[i].isBooked)
+    {
+      n++;
+      printf("%d. %-20s %02d/%02d/%04d - %02d/%02d/%04d\n", n, rooms[i].guestName,
+             rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year,
+             rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year);
+    }
+  }
+
+  int pick;
+  do
+  {
+    pick = getValidInteger("Select booking: ");
+  } while (pick < 1 || pick > matches);
+
+  n = 0;
+  for (int i = 0; i < roomCount; i++)
+  {
+    if (rooms[i].roomNumber == roomNumber && rooms[i].isBooked && ++n == pick)
+      return i;
+  }
+  return -1;
+}
+
+// Function to delete a room booking
+void deleteBooking(Room rooms[], int *roomCount)
+{
+  // Look the booking up on a consistent copy; the live table is only touched under the lock
+  int viewCount;
+  Room *view = viewBookingStore(rooms, roomCount, &viewCount);
+  if (viewCount == 0)
+  {
+    printf("\n===================\n");
+    printf("No bookings found.\n");
+    printf("===================\n");
+    return;
+  }
+
+  int roomNumber, index = -1;
+
+  roomNumber = getValidInteger("\nEnter room number to cancel: ");
+  index = findBookingByRoom(view, viewCount, roomNumber);
+
+  if (index == -1)
+  {
+    printf("\n=====================================\n");
+    printf("Room %d not found or not booked.\n", roomNumber);
+    printf("=====================================\n");
+    return;
+  }
+
+  // Display booking details and confirm deletion
+  Room target = view[index];
+  printf("\n=== BOOKING DETAILS ===\n");
+  printf("Room Number: %d\n", target.roomNumber);
+  printf("Guest Name : %s\n", target.guestName);
+  printf("Room Type  : %s\n", getRoomTypeName(target.roomType));
+  printf("Check-in   : %02d/%02d/%04d\n",
+         target.checkInDate.day, target.checkInDate.month, target.checkInDate.year);
+  printf("Check-out  : %02d/%02d/%04d\n",
+         target.checkOutDate.day, target.checkOutDate.month, target.checkOutDate.year);
+
+  char confirm;
+  printf("\nAre you sure you want to cancel this booking? (y/n): ");
+  clearInputBuffer();
+  scanf("%c", &confirm);
+
+  if ((confirm == 'y' || confirm == 'Y') && (index = relockBooking(rooms, *roomCount, &target)) == -1)
+  {
+    printf("\n=========================================================\n");
+    printf("The booking was changed at another desk. Nothing canceled.\n");
+    printf("=========================================================\n");
+  }
+  else if (confirm == 'y' || confirm == 'Y')
+  {
+    cancelBookingAt(rooms, roomCount, index);
+    unlockBookingStore(1);
+
+    printf("\n===============================\n");
+    printf("Booking canceled successfully.\n");
+    printf("===============================\n");
+  }
+  else
+  {
+    printf("\n===================\n");
+    printf("Cancellation aborted.\n");
+    printf("===================\n");
+  }
+
+  clearInputBuffer();
+}
+
+// Function to display all room bookings
+void displayBookings(Room rooms[], int roomCount)
+{
+  if (roomCount == 0)
+  {
+    printf("\n===================\n");
+    printf("No bookings found.\n");
+    printf("===================\n");
+    return;
+  }
+
+  printf("\n========================== BOOKING DETAILS ==========================\n");
+  printf("%-5s %-20s %-15s %-10s %-12s %-12s %-10s\n",
+         "Room", "Guest Name", "Contact", "Type", "Check-in", "Check-out", "Price");
+  printf("--------------------------------------------------------------------\n");
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    if (rooms[i].isBooked)
+    {
+      printf("%-5d %-20s %-15s %-10s %02d/%02d/%04d  %02d/%02d/%04d  $%-9.2f\n",
+             rooms[i].roomNumber,
+             rooms[i].guestName,
+             rooms[i].contact,
+             getRoomTypeName(rooms[i].roomType),
+             rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year,
+             rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year,
+             rooms[i].totalPrice);
+    }
+  }
+
+  printf("====================================================================\n");
+}
+
+// Function to search for a booking
+void searchBooking(Room rooms[], int roomCount)
+{
+  if (roomCount == 0)
+  {
+    printf("\n===================\n");
+    printf("No bookings found.\n");
+    printf("===================\n");
+    return;
+  }
+
+  printf("\n=== SEARCH BOOKING ===\n");
+  printf("1. Search by Room Number\n");
+  printf("2. Search by Guest Name\n");
+  printf("3. Filter Query\n");
+  printf("4. Check Availability\n");
+
+  int choice = getValidInteger("Enter your choice: ");
+
+  switch (choice)
+  {
+  case 1:
+  {
+    int roomNumber = getValidInteger("Enter room number: ");
+    int found = 0;
+
+    for (int i = 0; i < roomCount; i++)
+    {
+      if (rooms[i].roomNumber == roomNumber && rooms[i].isBooked)
+      {
+        found = 1;
+        printf("\n=== BOOKING DETAILS ===\n");
+        printf("Room Number: %d\n", rooms[i].roomNumber);
+        printf("Guest Name : %s\n", rooms[i].guestName);
+        printf("Contact    : %s\n", rooms[i].contact);
+        printf("Room Type  : %s\n", getRoomTypeName(rooms[i].roomType));
+        printf("Check-in   : %02d/%02d/%04d\n",
+               rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year);
+        printf("Check-out  : %02d/%02d/%04d\n",
+               rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year);
+        printf("Nights     : %d\n", rooms[i].nights);
+        printf("Total Price: $%.2f\n", rooms[i].totalPrice);
+        printf("=======================\n");
+      }
+    }
+
+    if (!found)
+    {
+      printf("\n===================================\n");
+      printf("No booking found for Room %d.\n", roomNumber);
+      printf("===================================\n");
+    }
+    break;
+  }
+
+  case 2:
+  {
+    char searchName[MAX_NAME_LENGTH];
+    int found = 0;
+
+    printf("Enter guest name: ");
+    clearInputBuffer();
+    fgets(searchName, sizeof(searchName), stdin);
+    searchName[strcspn(searchName, "\n")] = '\0'; // Remove newline
+
+    printf("\n=== SEARCH RESULTS ===\n");
+    for (int i = 0; i < roomCount; i++)
+    {
+      // Case-sensitive partial name match (strstr)
+      if (rooms[i].isBooked && strstr(rooms[i].guestName, searchName) != NULL)
+      {
+        found = 1;
+        printf("\n--- Booking %d ---\n", found);
+        printf("Room Number: %d\n", rooms[i].roomNumber);
+        printf("Guest Name : %s\n", rooms[i].guestName);
+        printf("Contact    : %s\n", rooms[i].contact);
+        printf("Room Type  : %s\n", getRoomTypeName(rooms[i].roomType));
+        printf("Check-in   : %02d/%02d/%04d\n",
+               rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year);
+        printf("Check-out  : %02d/%02d/%04d\n",
+               rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year);
+        printf("Total Price: $%.2f\n", rooms[i].totalPrice);
+      }
+    }
+
+    if (!found)
+    {
+      printf("\n==========================================\n");
+      printf("No bookings found for guest: %s\n", searchName);
+      printf("==========================================\n");
+    }
+    else
+    {
+      printf("\n=== End of Search Results ===\n");
+    }
+    break;
+  }
+
+  case 3:
+    filterBookings(rooms, roomCount);
+    break;
+
+  case 4:
+    checkAvailability(rooms, roomCount);
+    break;
+
+  default:
+    printf("\n==========================\n");
+    printf("Invalid choice. Try again.\n");
+    printf("==========================\n");
+    break;
+  }
+}
+
+// Function to modify an existing booking
+// The clerk's answers are collected first; the store is then locked and the booking found
+// again, so a change made meanwhile at another desk is never overwritten.
+void modifyBooking(Room rooms[], int *roomCount)
+{
+  // Look the booking up on a consistent copy; the live table is only touched under the lock
+  int viewCount;
+  Room *view = viewBookingStore(rooms, roomCount, &viewCount);
+  if (viewCount == 0)
+  {
+    printf("\n===================\n");
+    printf("No bookings found.\n");
+    printf("===================\n");
+    return;
+  }
+
+  int roomNumber, index = -1;
+  roomNumber = getValidInteger("Enter room number to modify: ");
+  index = findBookingByRoom(view, viewCount, roomNumber);
+
+  if (index == -1)
+  {
+    printf("\n===================================\n");
+    printf("Room %d not found or not booked.\n", roomNumber);
+    printf("===================================\n");
+    return;
+  }
+
+  Room before = view[index], updated;
+  int locked = 0;
+
+  // Display current booking details
+  printf("\n=== CURRENT BOOKING DETAILS ===\n");
+  printf("1. Guest Name : %s\n", before.guestName);
+  printf("2. Contact    : %s\n", before.contact);
+  printf("3. Room Type  : %s\n", getRoomTypeName(before.roomType));
+  printf("4. Check-in   : %02d/%02d/%04d\n",
+         before.checkInDate.day, before.checkInDate.month, before.checkInDate.year);
+  printf("5. Nights     : %d\n", before.nights);
+  printf("6. Return to Main Menu\n");
+
+  int choice = getValidInteger("\nEnter what to modify (1-6): ");
+
+  switch (choice)
+  {
+  case 1:
+  {
+    char newName[MAX_NAME_LENGTH];
+    printf("Enter new guest name: ");
+    clearInputBuffer();
+    fgets(newName, sizeof(newName), stdin);
+    newName[strcspn(newName, "\n")] = '\0'; // Remove newline
+
+    if ((index = relockBooking(rooms, *roomCount, &before)) == -1)
+      break;
+    locked = 1;
+    updated = rooms[index];
+    strcpy(updated.guestName, newName);
+    printf("\nGuest name updated successfully.\n");
+    break;
+  }
+
+  case 2:
+  {
+    char newContact[MAX_CONTACT_LENGTH];
+    do
+    {
+      printf("Enter new contact number: ");
+      clearInputBuffer();
+      fgets(newContact, sizeof(newContact), stdin);
+      newContact[strcspn(newContact, "\n")] = '\0'; // Remove newline
+
+      if (!validateContact(newContact))
+      {
+        printf("Invalid contact number. Please enter 8-12 digits with optional +/- symbols.\n");
+      }
+      else
+      {
+        if ((index = relockBooking(rooms, *roomCount, &before)) == -1)
+          break;
+        locked = 1;
+        updated = rooms[index];
+        strcpy(updated.contact, newContact);
+        printf("\nContact updated successfully.\n");
+        break;
+      }
+    } while (1);
+    break;
+  }
+
+  case 3:
+  {
+    printf("Current room type: %s\n", getRoomTypeName(before.roomType));
+    printRoomTypes();
+
+    char prompt[64];
+    snprintf(prompt, sizeof(prompt), "Enter new room type (1-%d): ", inventory.typeCount);
+    int newType;
+    do
+    {
+      newType = getValidInteger(prompt);
+      if (!isValidRoomType(newType))
+      {
+        printf("Invalid room type. Please enter a number from 1 to %d.\n", inventory.typeCount);
+      }
+    } while (!isValidRoomType(newType));
+
+    RoomType newRoomType = newType;
+    if ((index = relockBooking(rooms, *roomCount, &before)) == -1)
+      break;
+    locked = 1;
+    updated = rooms[index];
+
+    // Check if there's an available room of the new type, preferably with the current room's features
+    int newRoomNumber = assignMatchingRoom(rooms, *roomCount, newRoomType, updated.checkInDate,
+                                           updated.nights, index, 0, roomAttributes(updated.roomNumber));
+
+    if (newRoomNumber == -1)
+    {
+      printf("\nNo available rooms of the selected type. Modification canceled.\n");
+      break;
+    }
+
+    // Update room type, room number, and recalculate price
+    updated.roomType = newRoomType;
+    int oldRoomNumber = updated.roomNumber;
+    updated.roomNumber = newRoomNumber;
+    updated.totalPrice = getRoomTypeRate(newRoomType) * updated.nights;
+
+    printf("\nRoom type updated successfully.\n");
+    printf("New room number: %d (was %d)\n", newRoomNumber, oldRoomNumber);
+    printf("New total price: $%.2f\n", updated.totalPrice);
+    break;
+  }
+
+  case 4:
+  {
+    // Modify check-in date
+    Date today;
+    getCurrentDate(&today);
+    printf("Today is: %02d/%02d/%04d\n", today.day, today.month, today.year);
+
+    Date newCheckIn;
+    do
+    {
+      printf("Enter new check-in day (DD): ");
+      scanf("%d", &newCheckIn.day);
+      printf("Enter new check-in month (MM): ");
+      scanf("%d", &newCheckIn.month);
+      printf("Enter new check-in year (YYYY): ");
+      scanf("%d", &newCheckIn.year);
+
+      // Basic validation: check if date is valid and not in the past
+      if (!isDateValid(newCheckIn))
+      {
+        printf("Invalid date. Please enter a valid date.\n");
+        continue;
+      }
+
+      // Compare check-in date with today's date
+      if (newCheckIn.year < today.year ||
+          (newCheckIn.year == today.year && newCheckIn.month < today.month) ||
+          (newCheckIn.year == today.year && newCheckIn.month == today.month && newCheckIn.day < today.day))
+      {
+        printf("Check-in date cannot be in the past. Please enter a valid date.\n");
+        continue;
+      }
+
+      // Check if date is more than a year into the future
+      if (newCheckIn.year > today.year + 1 ||
+          (newCheckIn.year == today.year + 1 && newCheckIn.month > today.month) ||
+          (newCheckIn.year == today.year + 1 && newCheckIn.month == today.month && newCheckIn.day > today.day))
+      {
+        printf("Cannot book more than one year in advance. Please enter a valid date.\n");
+        continue;
+      }
+
+      break;
+    } while (1);
+    if ((index = relockBooking(rooms, *roomCount, &before)) == -1)
+      break;
+    locked = 1;
+    updated = rooms[index];
+
+    // Keep the same room if it is free for the new dates, otherwise move to another of the same type
+    int newRoomNumber = updated.roomNumber;
+    if (!isRoomFree(rooms, *roomCount, newRoomNumber, newCheckIn, updated.nights, index))
+    {
+      newRoomNumber = assignMatchingRoom(rooms, *roomCount, updated.roomType, newCheckIn, updated.nights,
+                                         index, 0, roomAttributes(updated.roomNumber));
+      if (newRoomNumber == -1)
+      {
+        printf("\nNo available rooms of this type for the new dates. Modification canceled.\n");
+        break;
+      }
+      printf("\nRoom %d is taken on the new dates. Moved to room %d.\n", updated.roomNumber, newRoomNumber);
+    }
+
+    updated.roomNumber = newRoomNumber;
+    updated.checkInDate = newCheckIn;
+    calculateCheckOutDate(&updated.checkInDate, &updated.checkOutDate, updated.nights);
+
+    printf("\nCheck-in date updated successfully.\n");
+    printf("New check-in date: %02d/%02d/%04d\n",
+           updated.checkInDate.day, updated.checkInDate.month, updated.checkInDate.year);
+    printf("New check-out date: %02d/%02d/%04d\n",
+           updated.checkOutDate.day, updated.checkOutDate.month, updated.checkOutDate.year);
+    break;
+  }
+
+  case 5:
+  {
+    int newNights;
+    do
+    {
+      newNights = getValidInteger("Enter new number of nights (1-30): ");
+      if (newNights < 1 || newNights > 30)
+      {
+        printf("Invalid number of nights. Please enter a value between 1 and 30.\n");
+      }
+    } while (newNights < 1 || newNights > 30);
+    if ((index = relockBooking(rooms, *roomCount, &before)) == -1)
+      break;
+    locked = 1;
+    updated = rooms[index];
+
+    // Keep the same room if it is free for the longer stay, otherwise move to another of the same type
+    int newRoomNumber = updated.roomNumber;
+    if (!isRoomFree(rooms, *roomCount, newRoomNumber, updated.checkInDate, newNights, index))
+    {
+      newRoomNumber = assignMatchingRoom(rooms, *roomCount, updated.roomType, updated.checkInDate,
+                                         newNights, index, 0, roomAttributes(updated.roomNumber));
+      if (newRoomNumber == -1)
+      {
+        printf("\nNo available rooms of this type for the new stay. Modification canceled.\n");
+        break;
+      }
+      printf("\nRoom %d is taken on the extra nights. Moved to room %d.\n", updated.roomNumber, newRoomNumber);
+    }
+
+    updated.roomNumber = newRoomNumber;
+    updated.nights = newNights;
+    updated.totalPrice = getRoomTypeRate(updated.roomType) * newNights;
+    calculateCheckOutDate(&updated.checkInDate, &updated.checkOutDate, newNights);
+
+    printf("\nBooking duration updated successfully.\n");
+    printf("New number of nights: %d\n", newNights);
+    printf("New check-out date: %02d/%02d/%04d\n",
+           updated.checkOutDate.day, updated.checkOutDate.month, updated.checkOutDate.year);
+    printf("New total price: $%.2f\n", updated.totalPrice);
+    break;
+  }
+
+  case 6:
+    printf("Returning to main menu.\n");
+    break;
+
+  default:
+    printf("\n==========================\n");
+    printf("Invalid choice. Try again.\n");
+    printf("==========================\n");
+    break;
+  }
+
+  if (locked)
+  {
+    updateBookingAt(rooms, index, &updated);
+    unlockBookingStore(1);
+  }
+  else if (index == -1)
+  {
+    printf("\nThe booking was changed at another desk. Modification canceled.\n");
+  }
+  clearInputBuffer();
+}
+
+// Function to save bookings to a file in text format
+void saveBookingsToFile(Room rooms[], int roomCount)
+{
+  FILE *file = fopen(BOOKINGS_TEMP_FILE, "w");
+  if (file == NULL)
+  {
+    printf("\n====================================\n");
+    printf("Error: Unable to save bookings to file.\n");
+    printf("====================================\n");
+    return;
+  }
+
+  // Header: booking count, the archive bytes and blocks this snapshot commits, the next booking id
+  // and the business date
+  fprintf(file, "%d %lld %d %d %d\n", roomCount, archiveCommittedBytes, archiveCommittedBlocks, nextBookingId,
+          businessDay);
+  for (int i = 0; i < roomCount; i++)
+  {
+    fprintf(file, "%d %d\n%s\n%s\n%d\n%d\n%f\n%d\n%d %d %d\n%d %d %d\n",
+            rooms[i].roomNumber,
+            rooms[i].bookingId,
+            rooms[i].guestName,
+            rooms[i].contact,
+            rooms[i].roomType,
+            rooms[i].nights,
+            rooms[i].totalPrice,
+            rooms[i].isBooked,
+            rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year,
+            rooms[i].checkOutDate.day, rooms[i].checkOutDate.month, rooms[i].checkOutDate.year);
+  }
+
+  if (fclose(file) != 0)
+  {
+    printf("\n====================================\n");
+    printf("Error: Unable to save bookings to file.\n");
+    printf("====================================\n");
+    return;
+  }
+
+  // Swap the new snapshot in whole, so a follower never reads a half-written file
+#ifdef _WIN32
+  remove(BOOKINGS_FILE); // rename() does not replace an existing file on Windows
+#endif
+  if (rename(BOOKINGS_TEMP_FILE, BOOKINGS_FILE) != 0)
+  {
+    printf("\n====================================\n");
+    printf("Error: Unable to save bookings to file.\n");
+    printf("====================================\n");
+    return;
+  }
+  resetJournal();
+
+  printf("\n============================\n");
+  printf("Bookings saved successfully.\n");
+  printf("============================\n");
+}
+
+// Function to load bookings from a file in text format
+void loadBookingsFromFile(Room rooms[], int *roomCount)
+{
+  char header[64];
+  archiveCommittedBytes = 0;
+  archiveCommittedBlocks = 0;
+  nextBookingId = 1;
+  businessDay = 0;
+
+  FILE *file = fopen(BOOKINGS_FILE, "r");
+  if (file == NULL)
+  {
+    printf("No previous bookings found.\n");
+    return;
+  }
+
+  if (fgets(header, sizeof(header), file) == NULL || sscanf(header, "%d", roomCount) != 1)
+  {
+    printf("Error reading booking count from file.\n");
+    fclose(file);
+    return;
+  }
+  if (*roomCount > MAX_BOOKINGS)
+  {
+    *roomCount = MAX_BOOKINGS;
+  }
+  if (sscanf(header, "%*d %lld %d %d %d", &archiveCommittedBytes, &archiveCommittedBlocks, &nextBookingId,
+             &businessDay) < 2)
+  {
+    archiveCommittedBytes = 0; // Snapshot from before the archive was committed through it
+    archiveCommittedBlocks = 0;
+  }
+
+  for (int i = 0; i < *roomCount; i++)
+  {
+    char line[32];
+    rooms[i].bookingId = 0;
+    if (fgets(line, sizeof(line), file) == NULL || sscanf(line, "%d %d", &rooms[i].roomNumber, &rooms[i].bookingId) < 1)
+      break;
+    if (fgets(rooms[i].guestName, sizeof(rooms[i].guestName), file) == NULL)
+      break;
+    rooms[i].guestName[strcspn(rooms[i].guestName, "\n")] = '\0';
+    if (fgets(rooms[i].contact, sizeof(rooms[i].contact), file) == NULL)
+      break;
+    rooms[i].contact[strcspn(rooms[i].contact, "\n")] = '\0';
+    int roomType;
+    if (fscanf(file, "%d\n", &roomType) != 1)
+      break;
+    rooms[i].roomType = (RoomType)roomType;
+    if (fscanf(file, "%d\n", &rooms[i].nights) != 1)
+      break;
+    if (fscanf(file, "%f\n", &rooms[i].totalPrice) != 1)
+      break;
+    if (fscanf(file, "%d\n", &rooms[i].isBooked) != 1)
+      break;
+    if (fscanf(file, "%d %d %d\n",
+               &rooms[i].checkInDate.day, &rooms[i].checkInDate.month, &rooms[i].checkInDate.year) != 3)
+      break;
+    if (fscanf(file, "%d %d %d\n",
+               &rooms[i].checkOutDate.day, &rooms[i].checkOutDate.month, &rooms[i].checkOutDate.year) != 3)
+      break;
+  }
+  fclose(file);
+
+  // Snapshots from before booking ids get fresh ones
+  for (int i = 0; i < *roomCount; i++)
+  {
+    if (rooms[i].bookingId >= nextBookingId)
+      nextBookingId = rooms[i].bookingId + 1;
+  }
+  for (int i = 0; i < *roomCount; i++)
+  {
+    if (rooms[i].bookingId <= 0)
+      rooms[i].bookingId = nextBookingId++;
+  }
+
+  invalidateAllAvailability();
+  printf("Bookings loaded successfully.\n");
+}
+// Function to write an unsigned integer as a variable-length (7 bits per byte) value
+int putVarint(unsigned char *buf, unsigned int value)
+{
+  int pos = 0;
+  while (value >= 0x80)
+  {
+    buf[pos++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  buf[pos++] = (unsigned char)value;
+  return pos;
+}
+
+// Function to read a variable-length integer, returns 0 if the buffer runs out
+int getVarint(const unsigned char *buf, int *pos, int len, unsigned int *value)
+{
+  unsigned int result = 0;
+  int shift = 0;
+
+  while (*pos < len && shift < 35)
+  {
+    unsigned char byte = buf[(*pos)++];
+    result |= (unsigned int)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+    {
+      *value = result;
+      return 1;
+    }
+    shift += 7;
+  }
+  return 0;
+}
+
+// Function to build a bitmask of the characters used in a guest name.
+// Letters a-z use bits 0-25 (case folded), digits bit 26, anything else bit 27.
+// A block can only contain a name matching a search if it has every bit of the search.
+unsigned int guestNameMask(const char *name)
+{
+  unsigned int mask = 0;
+  for (int i = 0; name[i] != '\0'; i++)
+  {
+    char c = name[i];
+    if (c >= 'A' && c <= 'Z')
+      c = c - 'A' + 'a';
+
+    if (c >= 'a' && c <= 'z')
+      mask |= 1u << (c - 'a');
+    else if (c >= '0' && c <= '9')
+      mask |= 1u << 26;
+    else
+      mask |= 1u << 27;
+  }
+  return mask;
+}
+
+// Function to encode one stay in the compact archive format.
+// Check-in is stored as a (zigzag) delta from the previous stay in the block,
+// and the check-out date is rebuilt from check-in + nights on decode.
+int encodeArchiveRecord(const Room *room, int prevCheckIn, unsigned char *buf)
+{
+  int pos = 0;
+  int delta = dateToDayNumber(room->checkInDate) - prevCheckIn;
+  int nameLength = strlen(room->guestName);
+  int contactLength = strlen(room->contact);
+
+  pos += putVarint(buf + pos, (unsigned int)room->roomNumber);
+  pos += putVarint(buf + pos, ((unsigned int)room->roomType << 1) | (room->isBooked ? 1u : 0u));
+  pos += putVarint(buf + pos, delta >= 0 ? (unsigned int)delta * 2 : (unsigned int)(-delta) * 2 - 1);
+  pos += putVarint(buf + pos, (unsigned int)room->nights);
+  pos += putVarint(buf + pos, (unsigned int)(room->totalPrice * 100.0f + 0.5f));
+  pos += putVarint(buf + pos, (unsigned int)nameLength);
+  memcpy(buf + pos, room->guestName, nameLength);
+  pos += nameLength;
+  pos += putVarint(buf + pos, (unsigned int)contactLength);
+  memcpy(buf + pos, room->contact, contactLength);
+  pos += contactLength;
+
+  return pos;
+}
+
+// Function to decode one archived stay, returns 0 if the block is corrupt
+int decodeArchiveRecord(const unsigned char *buf, int *pos, int len, int prevCheckIn, Room *room)
+{
+  unsigned int roomNumber, typeAndFlag, delta, nights, cents, nameLength, contactLength;
+
+  if (!getVarint(buf, pos, len, &roomNumber) ||
+      !getVarint(buf, pos, len, &typeAndFlag) ||
+      !getVarint(buf, pos, len, &delta) ||
+      !getVarint(buf, pos, len, &nights) ||
+      !getVarint(buf, pos, len, &cents) ||
+      !getVarint(buf, pos, len, &nameLength))
+    return 0;
+  if (nameLength >= MAX_NAME_LENGTH || *pos + (int)nameLength > len)
+    return 0;
+  memcpy(room->guestName, buf + *pos, nameLength);
+  room->guestName[nameLength] = '\0';
+  *pos += nameLength;
+
+  if (!getVarint(buf, pos, len, &contactLength))
+    return 0;
+  if (contactLength >= MAX_CONTACT_LENGTH || *pos + (int)contactLength > len)
+    return 0;
+  memcpy(room->contact, buf + *pos, contactLength);
+  room->contact[contactLength] = '\0';
+  *pos += contactLength;
+
+  int checkIn = prevCheckIn + ((delta & 1) ? -(int)((delta + 1) / 2) : (int)(delta / 2));
+
+  room->roomNumber = (int)roomNumber;
+  room->roomType = (RoomType)(typeAndFlag >> 1);
+  room->isBooked = (int)(typeAndFlag & 1);
+  room->nights = (int)nights;
+  room->totalPrice = cents / 100.0f;
+  dayNumberToDate(checkIn, &room->checkInDate);
+  calculateCheckOutDate(&room->checkInDate, &room->checkOutDate, room->nights);
+  return 1;
+}
+
+// Comparison function for sorting stays by check-in date
+int compareCheckIn(const void *a, const void *b)
+{
+  int dayA = dateToDayNumber(((const Room *)a)->checkInDate);
+  int dayB = dateToDayNumber(((const Room *)b)->checkInDate);
+  return (dayA > dayB) - (dayA < dayB);
+}
+
+// Function to move stays whose check-out date has passed into the archive file.
+// Stays are written in compressed blocks after the committed end of the archive, each described
+// by one sparse index entry, and then removed from the in-memory booking list.
+// The blocks only count once the caller saves the snapshot, which records the new committed end:
+// if the save never happens (error or crash) they are ignored and the stays stay in the hot set,
+// so a stay is never in both tiers and a retry does not archive it twice.
+// Returns the number of stays archived, or -1 on error (nothing changes).
+int archiveCompletedStays(Room rooms[], int *roomCount, Date today)
+{
+  int todayNumber = dateToDayNumber(today);
+  int completedCount = 0;
+
+  for (int i = 0; i < *roomCount; i++)
+  {
+    if (dateToDayNumber(rooms[i].checkOutDate) < todayNumber)
+      completedCount++;
+  }
+  if (completedCount == 0)
+    return 0;
+
+  Room *completed = malloc(completedCount * sizeof(Room));
+  if (completed == NULL)
+    return -1;
+
+  int n = 0;
+  for (int i = 0; i < *roomCount; i++)
+  {
+    if (dateToDayNumber(rooms[i].checkOutDate) < todayNumber)
+      completed[n++] = rooms[i];
+  }
+
+  // Sorting keeps check-in deltas small and block date ranges tight
+  qsort(completed, completedCount, sizeof(Room), compareCheckIn);
+
+  FILE *archive = fopen(ARCHIVE_FILE, "r+b");
+  if (archive == NULL)
+    archive = fopen(ARCHIVE_FILE, "w+b");
+  FILE *index = openArchiveIndex("r+b");
+  if (archive == NULL || index == NULL ||
+      fseek(archive, archiveCommittedBytes, SEEK_SET) != 0 ||
+      fseek(index, 8 + (long)archiveCommittedBlocks * ARCHIVE_INDEX_ENTRY_BYTES, SEEK_SET) != 0)
+  {
+    if (archive != NULL)
+      fclose(archive);
+    if (index != NULL)
+      fclose(index);
+    free(completed);
+    return -1;
+  }
+
+  long long offset = archiveCommittedBytes;
+  int blocks = 0;
+  unsigned char block[ARCHIVE_BLOCK_RECORDS * ARCHIVE_RECORD_MAX_BYTES];
+
+  for (int start = 0; start < completedCount; start += ARCHIVE_BLOCK_RECORDS)
+  {
+    int count = completedCount - start;
+    if (count > ARCHIVE_BLOCK_RECORDS)
+      count = ARCHIVE_BLOCK_RECORDS;
+
+    ArchiveIndexEntry entry;
+    entry.offset = offset;
+    entry.count = count;
+    entry.minCheckIn = dateToDayNumber(completed[start].checkInDate);
+    entry.maxCheckOut = 0;
+    entry.guestMask = 0;
+
+    int length = 0;
+    int prevCheckIn = entry.minCheckIn;
+    for (int i = start; i < start + count; i++)
+    {
+      length += encodeArchiveRecord(&completed[i], prevCheckIn, block + length);
+      prevCheckIn = dateToDayNumber(completed[i].checkInDate);
+
+      int checkOut = prevCheckIn + completed[i].nights;
+      if (checkOut > entry.maxCheckOut)
+        entry.maxCheckOut = checkOut;
+      entry.guestMask |= guestNameMask(completed[i].guestName);
+    }
+    entry.length = length;
+
+    // Block header (count, length) followed by the encoded stays
+    writeInt32(archive, count);
+    writeInt32(archive, length);
+    fwrite(block, 1, length, archive);
+    writeArchiveIndexEntry(index, &entry);
+    offset += 8 + length;
+    blocks++;
+  }
+
+  int ok = !ferror(archive) && !ferror(index);
+  if (fclose(archive) != 0)
+    ok = 0;
+  if (fclose(index) != 0)
+    ok = 0;
+  free(completed);
+
+  if (!ok)
+    return -1;
+
+  // Drop the stays from the hot set; the next snapshot commits the blocks
+  int kept = 0;
+  for (int i = 0; i < *roomCount; i++)
+  {
+    if (dateToDayNumber(rooms[i].checkOutDate) >= todayNumber)
+      rooms[kept++] = rooms[i];
+  }
+  *roomCount = kept;
+  archiveCommittedBytes = offset;
+  archiveCommittedBlocks += blocks;
+  rebuildCheckoutHeap(rooms, *roomCount);
+  invalidateAllAvailability();
+
+  return completedCount;
+}
+
+// Function to read a 32-bit little-endian integer, returns 0 at end of file
+int readInt32(FILE *file, int *value)
+{
+  unsigned char bytes[4];
+  if (fread(bytes, 1, 4, file) != 4)
+    return 0;
+  *value = (int)((unsigned int)bytes[0] | (unsigned int)bytes[1] << 8 | (unsigned int)bytes[2] << 16 |
+                 (unsigned int)bytes[3] << 24);
+  return 1;
+}
+
+// Function to open the archive index, positioned at the first entry.
+// mode "rb" returns NULL if there is no index (or it has another format); "r+b" creates one.
+FILE *openArchiveIndex(const char *mode)
+{
+  char magic[8];
+  FILE *index = fopen(ARCHIVE_INDEX_FILE, mode);
+
+  if (index == NULL && strcmp(mode, "r+b") == 0)
+  {
+    index = fopen(ARCHIVE_INDEX_FILE, "w+b");
+    if (index != NULL)
+      fwrite(ARCHIVE_INDEX_MAGIC, 1, 8, index);
+    return index;
+  }
+  if (index == NULL)
+    return NULL;
+
+  if (fread(magic, 1, 8, index) != 8 || memcmp(magic, ARCHIVE_INDEX_MAGIC, 8) != 0)
+  {
+    printf("Warning: %s is not a version 2 archive index and is ignored.\n", ARCHIVE_INDEX_FILE);
+    fclose(index);
+    return NULL;
+  }
+  return index;
+}
+
+// Function to write one index entry in the fixed-width file format
+void writeArchiveIndexEntry(FILE *index, const ArchiveIndexEntry *entry)
+{
+  writeInt32(index, (int)(entry->offset & 0xFFFFFFFF));
+  writeInt32(index, (int)(entry->offset >> 32));
+  writeInt32(index, entry->length);
+  writeInt32(index, entry->count);
+  writeInt32(index, entry->minCheckIn);
+  writeInt32(index, entry->maxCheckOut);
+  writeInt32(index, (int)entry->guestMask);
+}
+
+// Function to read one index entry, returns 0 at end of file
+int readArchiveIndexEntry(FILE *index, ArchiveIndexEntry *entry)
+{
+  int low, high, mask;
+  if (!readInt32(index, &low) || !readInt32(index, &high) || !readInt32(index, &entry->length) ||
+      !readInt32(index, &entry->count) || !readInt32(index, &entry->minCheckIn) ||
+      !readInt32(index, &entry->maxCheckOut) || !readInt32(index, &mask))
+    return 0;
+  entry->offset = (long long)high << 32 | (unsigned int)low;
+  entry->guestMask = (unsigned int)mask;
+  return 1;
+}
+
+// Function to read and decode one archive block into stays[] (room for ARCHIVE_BLOCK_RECORDS).
+// Returns the number of stays decoded, or -1 if the block cannot be read.
+int readArchiveBlock(FILE *archive, const ArchiveIndexEntry *entry, Room stays[])
+{
+  unsigned char block[ARCHIVE_BLOCK_RECORDS * ARCHIVE_RECORD_MAX_BYTES];
+
+  if (entry->length < 0 || entry->length > (int)sizeof(block) || entry->count > ARCHIVE_BLOCK_RECORDS ||
+      entry->offset + 8 + entry->length > archiveCommittedBytes ||
+      fseek(archive, (long)entry->offset + 8, SEEK_SET) != 0 ||
+      fread(block, 1, entry->length, archive) != (size_t)entry->length)
+    return -1;
+
+  int pos = 0;
+  int prevCheckIn = entry->minCheckIn;
+  for (int i = 0; i < entry->count; i++)
+  {
+    if (!decodeArchiveRecord(block, &pos, entry->length, prevCheckIn, &stays[i]))
+      return i;
+    prevCheckIn = dateToDayNumber(stays[i].checkInDate);
+  }
+  return entry->count;
+}
+
+// Function to look up archived stays by guest name and/or a date the guest was in-house.
+// Pass NULL for guestName or -1 for dayNumber to skip that condition.
+// Blocks whose index entry rules out a match are never read.
+void searchArchive(const char *guestName, int dayNumber)
+{
+  FILE *index = archiveCommittedBlocks > 0 ? openArchiveIndex("rb") : NULL;
+  FILE *archive = fopen(ARCHIVE_FILE, "rb");
+  if (index == NULL || archive == NULL)
+  {
+    if (index != NULL)
+      fclose(index);
+    if (archive != NULL)
+      fclose(archive);
+    printf("\n===================\n");
+    printf("No archived stays.\n");
+    printf("===================\n");
+    return;
+  }
+
+  unsigned int queryMask = guestName != NULL ? guestNameMask(guestName) : 0;
+  Room stays[ARCHIVE_BLOCK_RECORDS];
+  ArchiveIndexEntry entry;
+  int found = 0, blocksRead = 0;
+
+  printf("\n========================== STAY HISTORY ==========================\n");
+  printf("%-5s %-20s %-15s %-10s %-12s %-12s %-10s\n",
+         "Room", "Guest Name", "Contact", "Type", "Check-in", "Check-out", "Price");
+  printf("--------------------------------------------------------------------\n");
+
+  for (int b = 0; b < archiveCommittedBlocks && readArchiveIndexEntry(index, &entry); b++)
+  {
+    if (guestName != NULL && (entry.guestMask & queryMask) != queryMask)
+      continue;
+    if (dayNumber >= 0 && (dayNumber < entry.minCheckIn || dayNumber >= entry.maxCheckOut))
+      continue;
+
+    int count = readArchiveBlock(archive, &entry, stays);
+    if (count < 0)
+      continue;
+    blocksRead++;
+
+    for (int i = 0; i < count; i++)
+    {
+      int checkIn = dateToDayNumber(stays[i].checkInDate);
+      if (guestName != NULL && strstr(stays[i].guestName, guestName) == NULL)
+        continue;
+      if (dayNumber >= 0 && (dayNumber < checkIn || dayNumber >= checkIn + stays[i].nights))
+        continue;
+
+      found++;
+      printBookingRow(&stays[i]);
+    }
+  }
+
+  fclose(index);
+  fclose(archive);
+
+  printf("====================================================================\n");
+  printf("%d archived stay(s) found (%d block(s) read).\n", found, blocksRead);
+}
+
+// Function to show the archive and stay history menu
+void stayHistoryMenu(Room rooms[], int *roomCount)
+{
+  printf("\n=== ARCHIVE & STAY HISTORY ===\n");
+  printf("1. Archive Completed Stays\n");
+  printf("2. Search History by Guest Name\n");
+  printf("3. Search History by Date\n");
+  printf("4. Export Columnar File for Analytics\n");
+
+  int choice = getValidInteger("Enter your choice: ");
+
+  switch (choice)
+  {
+  case 1:
+  {
+    Date today;
+    getBusinessDate(&today);
+    if (!isDateValid(today))
+    {
+      printf("Invalid date. Archive canceled.\n");
+      break;
+    }
+
+    lockBookingStore();
+    int archived = archiveCompletedStays(rooms, roomCount, today);
+    if (archived < 0)
+    {
+      unlockBookingStore(0);
+      printf("\n====================================\n");
+      printf("Error: Unable to write archive file.\n");
+      printf("====================================\n");
+      break;
+    }
+
+    printf("\n%d completed stay(s) moved to the archive.\n", archived);
+    if (archived > 0)
+    {
+      char line[32];
+      snprintf(line, sizeof(line), "V %d", dateToDayNumber(today));
+      recordTrace(line);
+
+      // The snapshot commits the archived blocks; until it is saved they are ignored
+      saveBookingsToFile(rooms, *roomCount);
+    }
+    unlockBookingStore(archived > 0);
+    break;
+  }
+
+  case 2:
+  {
+    char searchName[MAX_NAME_LENGTH];
+    printf("Enter guest name: ");
+    fgets(searchName, sizeof(searchName), stdin);
+    searchName[strcspn(searchName, "\n")] = '\0'; // Remove newline
+    searchArchive(searchName, -1);
+    break;
+  }
+
+  case 3:
+  {
+    Date date;
+    date.day = getValidInteger("Enter day (DD): ");
+    date.month = getValidInteger("Enter month (MM): ");
+    date.year = getValidInteger("Enter year (YYYY): ");
+    if (!isDateValid(date))
+    {
+      printf("Invalid date.\n");
+      break;
+    }
+    searchArchive(NULL, dateToDayNumber(date));
+    break;
+  }
+
+  case 4:
+  {
+    int viewCount;
+    Room *view = viewBookingStore(rooms, roomCount, &viewCount);
+    long exported = exportColumnar(view, viewCount, EXPORT_FILE);
+    if (exported < 0)
+    {
+      printf("\n=======================================\n");
+      printf("Error: Unable to write the export file.\n");
+      printf("=======================================\n");
+      break;
+    }
+    printf("\n%ld stay(s) exported to %s.\n", exported, EXPORT_FILE);
+    break;
+  }
+
+  default:
+    printf("\n==========================\n");
+    printf("Invalid choice. Try again.\n");
+    printf("==========================\n");
+    break;
+  }
+}
+
+// Comparison function for sorting stays by check-in date (longer stays first on ties)
+int compareStaySpan(const void *a, const void *b)
+{
+  const StaySpan *x = (const StaySpan *)a;
+  const StaySpan *y = (const StaySpan *)b;
+  if (x->checkIn != y->checkIn)
+    return (x->checkIn > y->checkIn) - (x->checkIn < y->checkIn);
+  if (x->checkOut != y->checkOut)
+    return (x->checkOut < y->checkOut) - (x->checkOut > y->checkOut);
+  return (x->index > y->index) - (x->index < y->index);
+}
+
+// Comparison function for sorting stays by room, then check-in date
+int compareStayRoom(const void *a, const void *b)
+{
+  const StaySpan *x = (const StaySpan *)a;
+  const StaySpan *y = (const StaySpan *)b;
+  if (x->room != y->room)
+    return (x->room > y->room) - (x->room < y->room);
+  return (x->checkIn > y->checkIn) - (x->checkIn < y->checkIn);
+}
+
+// Function to count the free runs in the room calendar from a given day to the last check-out.
+// A run is a stretch of free nights in one room; fewer runs means longer runs,
+// so more stays can still find a single room for their whole visit.
+int countFreeRuns(Room rooms[], int roomCount, const int roomNumbers[], int fromDay)
+{
+  StaySpan *spans = malloc((roomCount > 0 ? roomCount : 1) * sizeof(StaySpan));
+  int n = 0, runs = 0, roomsUsed = 0, horizon = fromDay;
+
+  if (spans == NULL)
+    return 0;
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    int checkIn = dateToDayNumber(rooms[i].checkInDate);
+    if (!rooms[i].isBooked || checkIn + rooms[i].nights <= fromDay)
+      continue;
+    if (roomSlot(roomNumbers[i]) == -1)
+      continue;
+    spans[n].index = i;
+    spans[n].room = roomNumbers[i];
+    spans[n].checkIn = checkIn;
+    spans[n].checkOut = checkIn + rooms[i].nights;
+    if (spans[n].checkOut > horizon)
+      horizon = spans[n].checkOut;
+    n++;
+  }
+
+  qsort(spans, n, sizeof(StaySpan), compareStayRoom);
+  for (int i = 0; i < n;)
+  {
+    int cursor = fromDay;
+    int j = i;
+    for (; j < n && spans[j].room == spans[i].room; j++)
+    {
+      if (spans[j].checkIn > cursor)
+        runs++;
+      if (spans[j].checkOut > cursor)
+        cursor = spans[j].checkOut;
+    }
+    if (cursor < horizon)
+      runs++;
+    roomsUsed++;
+    i = j;
+  }
+  runs += inventory.roomCount - roomsUsed; // Empty rooms are one long run each
+
+  free(spans);
+  return runs;
+}
+
+// Function to repack the stays of one room class (interval graph colouring).
+// A class is the run of rooms first..first+classRooms-1 of the room table: one type with identical
+// attributes, so a guest who asked for a feature keeps it. Stays in rooms outside the class are ignored.
+// Stays that have not started are swept in check-in order and each goes to the free room
+// whose previous stay ended last (best fit), so gaps between stays stay as small as possible.
+// Rooms without a stay in progress are then relabelled so each packed schedule keeps the room
+// most of its stays already have, which keeps the move list short.
+// Returns 0 (leaving newRoomNumbers untouched for this class) if the stays cannot be packed.
+int planClassRepacking(Room rooms[], int roomCount, RoomType roomType, int first, int classRooms, int today,
+                       int newRoomNumbers[])
+{
+  int typeRooms = classRooms;
+  int base = today + 1; // First night a movable stay can start
+  int lastDay = base;
+  int movableCount = 0;
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    int r = roomSlot(rooms[i].roomNumber) - first;
+    if (!rooms[i].isBooked || rooms[i].roomType != roomType || r < 0 || r >= typeRooms)
+      continue;
+    int checkIn = dateToDayNumber(rooms[i].checkInDate);
+    if (checkIn + rooms[i].nights > lastDay)
+      lastDay = checkIn + rooms[i].nights;
+    if (checkIn >= base)
+      movableCount++;
+  }
+  if (movableCount == 0)
+    return 1;
+
+  int days = lastDay - base + 1;
+  int *busyUntil = malloc(typeRooms * sizeof(int));    // Night each room becomes free
+  int *hasFixed = calloc(typeRooms, sizeof(int));      // Room holds a stay that has started
+  int *bucketHead = malloc(days * sizeof(int));        // Rooms grouped by busyUntil
+  int *nextRoom = malloc(typeRooms * sizeof(int));
+  int *prevRoom = malloc(typeRooms * sizeof(int));
+  int *plannedRoom = malloc(typeRooms * sizeof(int));  // Relabel map from packed schedule to room
+  StaySpan *stays = malloc(movableCount * sizeof(StaySpan));
+  int ok = busyUntil && hasFixed && bucketHead && nextRoom && prevRoom && plannedRoom && stays;
+
+  if (ok)
+  {
+    for (int r = 0; r < typeRooms; r++)
+      busyUntil[r] = base;
+
+    int n = 0;
+    for (int i = 0; i < roomCount; i++)
+    {
+      int r = roomSlot(rooms[i].roomNumber) - first;
+      if (!rooms[i].isBooked || rooms[i].roomType != roomType || r < 0 || r >= typeRooms)
+        continue;
+      int checkIn = dateToDayNumber(rooms[i].checkInDate);
+      int checkOut = checkIn + rooms[i].nights;
+
+      if (checkIn >= base)
+      {
+        stays[n].index = i;
+        stays[n].room = r; // Current room, used as a tie-break
+        stays[n].checkIn = checkIn;
+        stays[n].checkOut = checkOut;
+        n++;
+      }
+      else if (checkOut > base)
+      {
+        hasFixed[r] = 1;
+        if (checkOut > busyUntil[r])
+          busyUntil[r] = checkOut;
+      }
+    }
+    qsort(stays, movableCount, sizeof(StaySpan), compareStaySpan);
+
+    for (int d = 0; d < days; d++)
+      bucketHead[d] = -1;
+    for (int r = typeRooms - 1; r >= 0; r--)
+    {
+      int d = busyUntil[r] - base;
+      prevRoom[r] = -1;
+      nextRoom[r] = bucketHead[d];
+      if (bucketHead[d] != -1)
+        prevRoom[bucketHead[d]] = r;
+      bucketHead[d] = r;
+    }
+
+    for (int s = 0; s < movableCount && ok; s++)
+    {
+      int room = -1;
+      for (int d = stays[s].checkIn - base; d >= 0; d--)
+      {
+        if (bucketHead[d] == -1)
+          continue;
+        int current = stays[s].room;
+        room = (current != -1 && busyUntil[current] == d + base) ? current : bucketHead[d];
+        break;
+      }
+      if (room == -1)
+      {
+        ok = 0; // More overlapping stays than rooms (should not happen with valid data)
+        break;
+      }
+
+      // Move the room from its old bucket to the bucket of the new check-out night
+      int oldDay = busyUntil[room] - base;
+      if (prevRoom[room] != -1)
+        nextRoom[prevRoom[room]] = nextRoom[room];
+      else
+        bucketHead[oldDay] = nextRoom[room];
+      if (nextRoom[room] != -1)
+        prevRoom[nextRoom[room]] = prevRoom[room];
+
+      int newDay = stays[s].checkOut - base;
+      busyUntil[room] = stays[s].checkOut;
+      prevRoom[room] = -1;
+      nextRoom[room] = bucketHead[newDay];
+      if (bucketHead[newDay] != -1)
+        prevRoom[bucketHead[newDay]] = room;
+      bucketHead[newDay] = room;
+
+      stays[s].packedRoom = room;
+    }
+  }
+
+  if (ok)
+  {
+    // Relabel schedules on rooms without a started stay; those rooms are interchangeable.
+    // Each schedule votes for the room most of its stays are in today, highest votes claim first.
+    int *votes = calloc(typeRooms, sizeof(int));
+    int *bestVote = malloc(typeRooms * sizeof(int));
+    int *bestRoom = malloc(typeRooms * sizeof(int));
+    int *claimed = calloc(typeRooms, sizeof(int));
+    int *order = malloc(typeRooms * sizeof(int));
+    int *byRoom = malloc(movableCount * sizeof(int));
+    int *roomStart = calloc(typeRooms + 1, sizeof(int));
+
+    if (votes && bestVote && bestRoom && claimed && order && byRoom && roomStart)
+    {
+      // Group the packed stays by schedule (counting sort)
+      for (int s = 0; s < movableCount; s++)
+        roomStart[stays[s].packedRoom + 1]++;
+      for (int r = 0; r < typeRooms; r++)
+        roomStart[r + 1] += roomStart[r];
+      for (int s = 0; s < movableCount; s++)
+        byRoom[roomStart[stays[s].packedRoom]++] = s;
+      for (int r = typeRooms; r > 0; r--)
+        roomStart[r] = roomStart[r - 1];
+      roomStart[0] = 0;
+
+      int orderCount = 0;
+      for (int r = 0; r < typeRooms; r++)
+      {
+        plannedRoom[r] = r;
+        bestVote[r] = 0;
+        bestRoom[r] = -1;
+        if (hasFixed[r])
+        {
+          claimed[r] = 1;
+          continue;
+        }
+
+        for (int k = roomStart[r]; k < roomStart[r + 1]; k++)
+        {
+          int current = stays[byRoom[k]].room;
+          if (current != -1 && !hasFixed[current] && ++votes[current] > bestVote[r])
+          {
+            bestVote[r] = votes[current];
+            bestRoom[r] = current;
+          }
+        }
+        for (int k = roomStart[r]; k < roomStart[r + 1]; k++)
+        {
+          if (stays[byRoom[k]].room != -1)
+            votes[stays[byRoom[k]].room] = 0;
+        }
+        order[orderCount++] = r;
+      }
+
+      // Highest vote first (insertion sort is fine for one type's rooms)
+      for (int i = 1; i < orderCount; i++)
+      {
+        int r = order[i], j = i - 1;
+        while (j >= 0 && bestVote[order[j]] < bestVote[r])
+        {
+          order[j + 1] = order[j];
+          j--;
+        }
+        order[j + 1] = r;
+      }
+
+      int *unplaced = votes; // Reuse as the list of schedules still needing a room
+      int unplacedCount = 0;
+      for (int i = 0; i < orderCount; i++)
+      {
+        int r = order[i];
+        if (bestRoom[r] != -1 && !claimed[bestRoom[r]])
+        {
+          plannedRoom[r] = bestRoom[r];
+          claimed[bestRoom[r]] = 1;
+        }
+        else
+        {
+          unplaced[unplacedCount++] = r;
+        }
+      }
+      int freeRoom = 0;
+      for (int i = 0; i < unplacedCount; i++)
+      {
+        while (claimed[freeRoom])
+          freeRoom++;
+        plannedRoom[unplaced[i]] = freeRoom;
+        claimed[freeRoom] = 1;
+      }
+    }
+    else
+    {
+      for (int r = 0; r < typeRooms; r++)
+        plannedRoom[r] = r;
+    }
+
+    for (int s = 0; s < movableCount; s++)
+      newRoomNumbers[stays[s].index] = inventory.roomNumber[first + plannedRoom[stays[s].packedRoom]];
+
+    free(votes);
+    free(bestVote);
+    free(bestRoom);
+    free(claimed);
+    free(order);
+    free(byRoom);
+    free(roomStart);
+  }
+
+  free(busyUntil);
+  free(hasFixed);
+  free(bucketHead);
+  free(nextRoom);
+  free(prevRoom);
+  free(plannedRoom);
+  free(stays);
+  return ok;
+}
+
+// Function to plan new room numbers for every stay that has not started yet.
+// newRoomNumbers[i] receives the planned room of booking i (unchanged for stays that cannot move).
+// Returns the number of bookings whose room changes, or 0 when repacking would not
+// reduce the number of free runs in the calendar (reported through runsBefore/runsAfter).
+int planRoomRepacking(Room rooms[], int roomCount, Date today, int newRoomNumbers[],
+                      int *runsBefore, int *runsAfter)
+{
+  int todayNumber = dateToDayNumber(today);
+  int *currentRoomNumbers = malloc((roomCount > 0 ? roomCount : 1) * sizeof(int));
+  *runsBefore = 0;
+  *runsAfter = 0;
+  if (currentRoomNumbers == NULL)
+    return 0;
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    currentRoomNumbers[i] = rooms[i].roomNumber;
+    newRoomNumbers[i] = rooms[i].roomNumber;
+  }
+
+  // Stays only move between rooms of the same type and attributes
+  for (int first = 0, last; first < inventory.roomCount; first = last)
+  {
+    RoomType type = 0;
+    for (int t = 1; t <= inventory.typeCount; t++)
+    {
+      if (first >= inventory.types[t].first && first < inventory.types[t].first + inventory.types[t].count)
+        type = t;
+    }
+    int typeEnd = inventory.types[type].first + inventory.types[type].count;
+    for (last = first + 1; last < typeEnd && inventory.attributes[last] == inventory.attributes[first]; last++)
+      ;
+
+    if (!planClassRepacking(rooms, roomCount, type, first, last - first, todayNumber, newRoomNumbers))
+    {
+      // Keep today's plan for this class
+      for (int i = 0; i < roomCount; i++)
+      {
+        int slot = roomSlot(rooms[i].roomNumber);
+        if (rooms[i].roomType == type && slot >= first && slot < last)
+          newRoomNumbers[i] = rooms[i].roomNumber;
+      }
+    }
+  }
+
+  int moves = 0;
+  *runsBefore = countFreeRuns(rooms, roomCount, currentRoomNumbers, todayNumber);
+  *runsAfter = countFreeRuns(rooms, roomCount, newRoomNumbers, todayNumber);
+  if (*runsAfter < *runsBefore)
+  {
+    for (int i = 0; i < roomCount; i++)
+    {
+      if (newRoomNumbers[i] != rooms[i].roomNumber)
+        moves++;
+    }
+  }
+  else
+  {
+    memcpy(newRoomNumbers, currentRoomNumbers, roomCount * sizeof(int));
+    *runsAfter = *runsBefore;
+  }
+
+  free(currentRoomNumbers);
+  return moves;
+}
+
+// Function to defragment the room calendar by reassigning rooms for future stays
+void optimizeRoomAssignments(Room rooms[], int *roomCount)
+{
+  if (*roomCount == 0)
+  {
+    printf("\n===================\n");
+    printf("No bookings found.\n");
+    printf("===================\n");
+    return;
+  }
+
+  Date today;
+  getBusinessDate(&today);
+  if (!isDateValid(today))
+  {
+    printf("Invalid date. Optimization canceled.\n");
+    return;
+  }
+
+  int *newRoomNumbers = malloc(MAX_BOOKINGS * sizeof(int));
+  if (newRoomNumbers == NULL)
+    return;
+
+  // Plan against a stable store; the plan is only applied if nothing changes before the clerk confirms
+  int runsBefore, runsAfter;
+  lockBookingStore();
+  int plannedCount = *roomCount;
+  int moves = planRoomRepacking(rooms, plannedCount, today, newRoomNumbers, &runsBefore, &runsAfter);
+  unsigned int plannedVersion = bookingStoreVersion();
+  unlockBookingStore(0);
+  if (moves == 0)
+  {
+    printf("\n=================================================\n");
+    printf("Room calendar is already packed. No moves needed.\n");
+    printf("=================================================\n");
+    free(newRoomNumbers);
+    return;
+  }
+
+  printf("\n====================== ROOM MOVES ======================\n");
+  printf("%-20s %-10s %-12s %-6s %-6s\n", "Guest Name", "Type", "Check-in", "From", "To");
+  printf("--------------------------------------------------------\n");
+  for (int i = 0; i < plannedCount; i++)
+  {
+    if (newRoomNumbers[i] != rooms[i].roomNumber)
+    {
+      printf("%-20s %-10s %02d/%02d/%04d   %-6d %-6d\n",
+             rooms[i].guestName, getRoomTypeName(rooms[i].roomType),
+             rooms[i].checkInDate.day, rooms[i].checkInDate.month, rooms[i].checkInDate.year,
+             rooms[i].roomNumber, newRoomNumbers[i]);
+    }
+  }
+  printf("========================================================\n");
+  printf("%d move(s). Free runs in the calendar: %d -> %d\n", moves, runsBefore, runsAfter);
+
+  char confirm;
+  printf("\nApply these room moves? (y/n): ");
+  scanf(" %c", &confirm);
+  clearInputBuffer();
+
+  if (confirm == 'y' || confirm == 'Y')
+  {
+    lockBookingStore();
+    if (bookingStoreVersion() != plannedVersion)
+    {
+      unlockBookingStore(0);
+      printf("\nBookings were changed at another desk meanwhile. No changes made - please optimize again.\n");
+      free(newRoomNumbers);
+      return;
+    }
+    for (int i = 0; i < plannedCount; i++)
+    {
+      if (rooms[i].roomNumber != newRoomNumbers[i])
+      {
+        Room moved = rooms[i];
+        moved.roomNumber = newRoomNumbers[i];
+        updateBookingAt(rooms, i, &moved);
+      }
+    }
+    unlockBookingStore(1);
+    printf("\nRoom assignments updated.\n");
+  }
+  else
+  {
+    printf("\nNo changes made.\n");
+  }
+
+  free(newRoomNumbers);
+}
+
+// Function to print one booking as a row of the booking table
+void printBookingRow(const Room *room)
+{
+  printf("%-5d %-20s %-15s %-10s %02d/%02d/%04d  %02d/%02d/%04d  $%-9.2f\n",
+         room->roomNumber,
+         room->guestName,
+         room->contact,
+         getRoomTypeName(room->roomType),
+         room->checkInDate.day, room->checkInDate.month, room->checkInDate.year,
+         room->checkOutDate.day, room->checkOutDate.month, room->checkOutDate.year,
+         room->totalPrice);
+}
+
+// Function to compare two strings ignoring case
+int equalsIgnoreCase(const char *a, const char *b)
+{
+  for (; *a != '\0' && *b != '\0'; a++, b++)
+  {
+    char x = (*a >= 'A' && *a <= 'Z') ? *a - 'A' + 'a' : *a;
+    char y = (*b >= 'A' && *b <= 'Z') ? *b - 'A' + 'a' : *b;
+    if (x != y)
+      return 0;
+  }
+  return *a == *b;
+}
+
+// Function to check if text contains pattern, ignoring case
+int containsIgnoreCase(const char *text, const char *pattern)
+{
+  int patternLength = strlen(pattern);
+  for (; *text != '\0'; text++)
+  {
+    int k = 0;
+    while (k < patternLength && text[k] != '\0')
+    {
+      char x = (text[k] >= 'A' && text[k] <= 'Z') ? text[k] - 'A' + 'a' : text[k];
+      char y = (pattern[k] >= 'A' && pattern[k] <= 'Z') ? pattern[k] - 'A' + 'a' : pattern[k];
+      if (x != y)
+        break;
+      k++;
+    }
+    if (k == patternLength)
+      return 1;
+  }
+  return patternLength == 0;
+}
+
+// Column accessors used by compiled filters (all integer columns, price in cents)
+int columnRoom(const Room *room) { return room->roomNumber; }
+int columnType(const Room *room) { return room->roomType; }
+int columnNights(const Room *room) { return room->nights; }
+int columnPrice(const Room *room) { return (int)(room->totalPrice * 100.0f + 0.5f); }
+int columnCheckIn(const Room *room) { return dateToDayNumber(room->checkInDate); }
+int columnCheckOut(const Room *room) { return dateToDayNumber(room->checkInDate) + room->nights; }
+
+// Compiled tests - each term of a query is bound to exactly one of these at compile time
+int testIntRange(const FilterTerm *term, const Room *room)
+{
+  int value = term->column(room);
+  return value >= term->low && value <= term->high;
+}
+
+int testIntNotEqual(const FilterTerm *term, const Room *room)
+{
+  return term->column(room) != term->low;
+}
+
+int testNameContains(const FilterTerm *term, const Room *room)
+{
+  return containsIgnoreCase(room->guestName, term->text);
+}
+
+int testNameEquals(const FilterTerm *term, const Room *room)
+{
+  return equalsIgnoreCase(room->guestName, term->text);
+}
+
+int testContactContains(const FilterTerm *term, const Room *room)
+{
+  return strstr(room->contact, term->text) != NULL;
+}
+
+int testContactEquals(const FilterTerm *term, const Room *room)
+{
+  return strcmp(room->contact, term->text) == 0;
+}
+
+// Function to read the next token of a filter query.
+// Returns the token length (0 at the end), quoted strings come back without quotes.
+int nextQueryToken(const char **cursor, char *token, int tokenSize)
+{
+  const char *p = *cursor;
+  int n = 0;
+
+  while (*p == ' ' || *p == '\t')
+    p++;
+
+  if (*p == '"')
+  {
+    p++;
+    while (*p != '\0' && *p != '"' && n < tokenSize - 1)
+      token[n++] = *p++;
+    if (*p == '"')
+      p++;
+    token[n] = '\0';
+    *cursor = p;
+    return n > 0 ? n : -1; // -1 marks an empty quoted string
+  }
+
+  if (*p == '<' || *p == '>' || *p == '!' || *p == '=' || *p == '~')
+  {
+    token[n++] = *p++;
+    if (*p == '=' && token[0] != '~' && token[0] != '=')
+      token[n++] = *p++;
+  }
+  else
+  {
+    while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '<' && *p != '>' &&
+           *p != '!' && *p != '=' && *p != '~' && *p != '"' && n < tokenSize - 1)
+      token[n++] = *p++;
+  }
+
+  token[n] = '\0';
+  *cursor = p;
+  return n;
+}
+
+// Function to parse a whole number that fits in an int, returns 0 if there is none or it does not fit
+int parseQueryNumber(const char *text, int *number)
+{
+  char *end;
+  long long value = strtoll(text, &end, 10); // Clamps on overflow, which the range check rejects
+
+  if (end == text || value < INT_MIN || value > INT_MAX)
+    return 0;
+  *number = (int)value;
+  return 1;
+}
+
+// Function to parse a price into cents, returns 0 if there is none or it does not fit in an int
+int parseQueryPrice(const char *text, int *cents)
+{
+  char *end;
+  double value = strtod(text, &end) * 100.0;
+
+  if (end == text || !(value > INT_MIN && value < INT_MAX - 1))
+    return 0;
+  *cents = (int)((float)value + 0.5f); // Rounded as columnPrice rounds stored prices
+  return 1;
+}
+
+// Function to parse a date written as YYYY-MM-DD or DD/MM/YYYY into a day number
+int parseQueryDate(const char *text, int *dayNumber)
+{
+  Date date;
+  if (sscanf(text, "%d-%d-%d", &date.year, &date.month, &date.day) != 3 &&
+      sscanf(text, "%d/%d/%d", &date.day, &date.month, &date.year) != 3)
+    return 0;
+  if (date.year < 1 || date.year > 9999 || !isDateValid(date))
+    return 0;
+  *dayNumber = dateToDayNumber(date);
+  return 1;
+}
+
+// Function to look up the column accessor for an integer field name
+int (*queryColumn(const char *field))(const Room *)
+{
+  if (equalsIgnoreCase(field, "room"))
+    return columnRoom;
+  if (equalsIgnoreCase(field, "type"))
+    return columnType;
+  if (equalsIgnoreCase(field, "nights"))
+    return columnNights;
+  if (equalsIgnoreCase(field, "price"))
+    return columnPrice;
+  if (equalsIgnoreCase(field, "checkin"))
+    return columnCheckIn;
+  if (equalsIgnoreCase(field, "checkout"))
+    return columnCheckOut;
+  return NULL;
+}
+
+// Function to compile a filter query into a list of bound tests.
+// Grammar: term [AND term]... [ORDER BY field [ASC|DESC]] [LIMIT n]
+//   term  : field op value, fields room type nights price checkin checkout name contact
+//   op    : = != < <= > >=, and ~ (contains) for name/contact
+// Range tests on the same column are merged, and terms are ordered so the cheap
+// integer checks reject a row before any string is looked at. The most selective-looking
+// range (see queryIndexRank) is marked to be read through a column index.
+// Returns 1 on success, 0 with a message in error.
+int compileBookingQuery(const char *text, BookingQuery *query, char *error, int errorSize)
+{
+  const char *cursor = text;
+  char field[32], op[4], value[MAX_NAME_LENGTH];
+
+  memset(query, 0, sizeof(*query));
+  query->indexTerm = -1;
+
+  while (1)
+  {
+    if (nextQueryToken(&cursor, field, sizeof(field)) <= 0)
+    {
+      snprintf(error, errorSize, "Expected a field name.");
+      return 0;
+    }
+    if (nextQueryToken(&cursor, op, sizeof(op)) <= 0)
+    {
+      snprintf(error, errorSize, "Expected an operator after '%s'.", field);
+      return 0;
+    }
+    if (nextQueryToken(&cursor, value, sizeof(value)) == 0)
+    {
+      snprintf(error, errorSize, "Expected a value after '%s %s'.", field, op);
+      return 0;
+    }
+    if (query->termCount >= MAX_FILTER_TERMS)
+    {
+      snprintf(error, errorSize, "Too many conditions (max %d).", MAX_FILTER_TERMS);
+      return 0;
+    }
+
+    FilterTerm *term = &query->terms[query->termCount];
+    int isName = equalsIgnoreCase(field, "name");
+    int isContact = equalsIgnoreCase(field, "contact");
+
+    if (isName || isContact)
+    {
+      if (strcmp(op, "~") == 0)
+        term->test = isName ? testNameContains : testContactContains;
+      else if (strcmp(op, "=") == 0)
+        term->test = isName ? testNameEquals : testContactEquals;
+      else
+      {
+        snprintf(error, errorSize, "Use = or ~ with '%s'.", field);
+        return 0;
+      }
+      strcpy(term->text, value);
+      term->cost = 2;
+      query->termCount++;
+    }
+    else
+    {
+      int (*column)(const Room *) = queryColumn(field);
+      int number;
+
+      if (column == NULL)
+      {
+        snprintf(error, errorSize, "Unknown field '%s'.", field);
+        return 0;
+      }
+
+      if (column == columnCheckIn || column == columnCheckOut)
+      {
+        if (!parseQueryDate(value, &number))
+        {
+          snprintf(error, errorSize, "Invalid date '%s' (use YYYY-MM-DD).", value);
+          return 0;
+        }
+      }
+      else if (column == columnType)
+      {
+        number = 0;
+        for (int type = 1; type <= inventory.typeCount; type++)
+        {
+          if (equalsIgnoreCase(value, getRoomTypeName(type)))
+            number = type;
+        }
+        if (number == 0 && !parseQueryNumber(value, &number))
+        {
+          snprintf(error, errorSize, "Unknown room type '%s'.", value);
+          return 0;
+        }
+      }
+      else if (column == columnPrice)
+      {
+        if (!parseQueryPrice(value, &number))
+        {
+          snprintf(error, errorSize, "Invalid price '%s'.", value);
+          return 0;
+        }
+      }
+      else if (!parseQueryNumber(value, &number))
+      {
+        snprintf(error, errorSize, "Invalid number '%s'.", value);
+        return 0;
+      }
+
+      if (strcmp(op, "!=") == 0)
+      {
+        term->test = testIntNotEqual;
+        term->column = column;
+        term->low = number;
+        term->cost = 1;
+        query->termCount++;
+      }
+      else
+      {
+        int low = INT_MIN, high = INT_MAX;
+        if (strcmp(op, "=") == 0)
+          low = high = number;
+        else if (strcmp(op, "<") == 0)
+        {
+          if (number == INT_MIN)
+            query->matchesNothing = 1; // Nothing is below INT_MIN
+          else
+            high = number - 1;
+        }
+        else if (strcmp(op, "<=") == 0)
+          high = number;
+        else if (strcmp(op, ">") == 0)
+        {
+          if (number == INT_MAX)
+            query->matchesNothing = 1; // Nothing is above INT_MAX
+          else
+            low = number + 1;
+        }
+        else if (strcmp(op, ">=") == 0)
+          low = number;
+        else
+        {
+          snprintf(error, errorSize, "Operator '%s' does not work with '%s'.", op, field);
+          return 0;
+        }
+
+        // Merge with an existing range on the same column
+        FilterTerm *range = NULL;
+        for (int t = 0; t < query->termCount; t++)
+        {
+          if (query->terms[t].test == testIntRange && query->terms[t].column == column)
+            range = &query->terms[t];
+        }
+        if (range == NULL)
+        {
+          range = term;
+          range->test = testIntRange;
+          range->column = column;
+          range->low = INT_MIN;
+          range->high = INT_MAX;
+          range->cost = 0;
+          query->termCount++;
+        }
+        if (low > range->low)
+          range->low = low;
+        if (high < range->high)
+          range->high = high;
+        if (range->low > range->high)
+          query->matchesNothing = 1;
+      }
+    }
+
+    // Either another AND term, or the ORDER BY / LIMIT clauses
+    char word[32];
+    const char *before = cursor;
+    int length = nextQueryToken(&cursor, word, sizeof(word));
+    if (length == 0)
+      break;
+    if (equalsIgnoreCase(word, "AND"))
+      continue;
+    cursor = before;
+    break;
+  }
+
+  char word[32];
+  while (nextQueryToken(&cursor, word, sizeof(word)) > 0)
+  {
+    if (equalsIgnoreCase(word, "ORDER"))
+    {
+      if (nextQueryToken(&cursor, word, sizeof(word)) <= 0 || !equalsIgnoreCase(word, "BY") ||
+          nextQueryToken(&cursor, word, sizeof(word)) <= 0 || (query->sortColumn = queryColumn(word)) == NULL)
+      {
+        snprintf(error, errorSize, "Use ORDER BY room/type/nights/price/checkin/checkout.");
+        return 0;
+      }
+
+      const char *before = cursor;
+      if (nextQueryToken(&cursor, word, sizeof(word)) > 0 && equalsIgnoreCase(word, "DESC"))
+        query->descending = 1;
+      else if (!equalsIgnoreCase(word, "ASC"))
+        cursor = before;
+    }
+    else if (equalsIgnoreCase(word, "LIMIT"))
+    {
+      if (nextQueryToken(&cursor, word, sizeof(word)) <= 0 || !parseQueryNumber(word, &query->limit) ||
+          query->limit < 1)
+      {
+        snprintf(error, errorSize, "LIMIT needs a positive number.");
+        return 0;
+      }
+    }
+    else
+    {
+      snprintf(error, errorSize, "Unexpected '%s' (join conditions with AND).", word);
+      return 0;
+    }
+  }
+
+  // Cheapest tests first (stable insertion sort, at most MAX_FILTER_TERMS terms)
+  for (int i = 1; i < query->termCount; i++)
+  {
+    FilterTerm term = query->terms[i];
+    int j = i - 1;
+    while (j >= 0 && query->terms[j].cost > term.cost)
+    {
+      query->terms[j + 1] = query->terms[j];
+      j--;
+    }
+    query->terms[j + 1] = term;
+  }
+
+  // Pick the range to drive an index read
+  int bestRank = INT_MAX;
+  for (int t = 0; t < query->termCount; t++)
+  {
+    int rank = queryIndexRank(&query->terms[t]);
+    if (rank < bestRank)
+    {
+      bestRank = rank;
+      query->indexTerm = t;
+    }
+  }
+
+  return 1;
+}
+
+// Function to rank a term as an index candidate, lower is better (INT_MAX: cannot use an index).
+// Without statistics the shape decides: an equality beats a closed range, which beats an
+// open one; among equal shapes, columns with many distinct values come first.
+int queryIndexRank(const FilterTerm *term)
+{
+  static int (*const columns[QUERY_INDEX_COLUMNS])(const Room *) = {
+      columnRoom, columnCheckIn, columnCheckOut, columnPrice, columnNights, columnType};
+
+  if (term->test != testIntRange)
+    return INT_MAX;
+  if (term->low == INT_MIN && term->high == INT_MAX)
+    return INT_MAX;
+
+  int shape = term->low == term->high ? 0 : (term->low != INT_MIN && term->high != INT_MAX) ? 1 : 2;
+  for (int c = 0; c < QUERY_INDEX_COLUMNS; c++)
+  {
+    if (columns[c] == term->column)
+      return shape * QUERY_INDEX_COLUMNS + c;
+  }
+  return INT_MAX;
+}
+
+// Comparison function for building a column index (value, then booking order)
+int compareIndexedRow(const void *a, const void *b)
+{
+  const int *x = a;
+  const int *y = b;
+  if (x[0] != y[0])
+    return (x[0] > y[0]) - (x[0] < y[0]);
+  return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+// Function to get the index for a column, building it if the bookings changed since.
+// Returns NULL if memory runs out (the caller scans instead).
+ColumnIndex *getColumnIndex(Room rooms[], int roomCount, int (*column)(const Room *))
+{
+  ColumnIndex *index = NULL;
+  for (int c = 0; c < QUERY_INDEX_COLUMNS && index == NULL; c++)
+  {
+    if (queryIndexes[c].column == column || queryIndexes[c].column == NULL)
+      index = &queryIndexes[c];
+  }
+  if (index == NULL)
+    return NULL;
+  if (index->column == column && index->rooms == rooms && index->version == bookingsVersion &&
+      index->count == roomCount)
+    return index;
+
+  if (roomCount > index->capacity)
+  {
+    int *keys = realloc(index->keys, roomCount * sizeof(int));
+    if (keys != NULL)
+      index->keys = keys;
+    int *rows = realloc(index->rows, roomCount * sizeof(int));
+    if (rows != NULL)
+      index->rows = rows;
+    if (keys == NULL || rows == NULL)
+      return NULL;
+    index->capacity = roomCount;
+  }
+
+  // Sort (value, row) pairs, then split them into the two arrays
+  int *pairs = malloc((roomCount > 0 ? roomCount : 1) * 2 * sizeof(int));
+  if (pairs == NULL)
+    return NULL;
+  for (int i = 0; i < roomCount; i++)
+  {
+    pairs[2 * i] = column(&rooms[i]);
+    pairs[2 * i + 1] = i;
+  }
+  qsort(pairs, roomCount, 2 * sizeof(int), compareIndexedRow);
+  for (int i = 0; i < roomCount; i++)
+  {
+    index->keys[i] = pairs[2 * i];
+    index->rows[i] = pairs[2 * i + 1];
+  }
+  free(pairs);
+
+  index->column = column;
+  index->count = roomCount;
+  index->rooms = rooms;
+  index->version = bookingsVersion;
+  return index;
+}
+
+// Function to list the rows inside the query's index range, in booking order.
+// Returns the row count, or -1 if the query should scan the table instead.
+int indexedQueryRows(Room rooms[], int roomCount, const BookingQuery *query, int rows[])
+{
+  if (query->indexTerm < 0 || roomCount < QUERY_INDEX_MIN_ROWS)
+    return -1;
+
+  const FilterTerm *term = &query->terms[query->indexTerm];
+  ColumnIndex *index = getColumnIndex(rooms, roomCount, term->column);
+  if (index == NULL)
+    return -1;
+
+  // First key >= low, and first key > high
+  int lo = 0, hi = index->count;
+  while (lo < hi)
+  {
+    int mid = lo + (hi - lo) / 2;
+    if (index->keys[mid] < term->low)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  int start = lo;
+  hi = index->count;
+  while (lo < hi)
+  {
+    int mid = lo + (hi - lo) / 2;
+    if (index->keys[mid] <= term->high)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  // A range covering most of the table is cheaper to scan in place
+  int count = lo - start;
+  if (count > roomCount / 2)
+    return -1;
+
+  memcpy(rows, index->rows + start, count * sizeof(int));
+  qsort(rows, count, sizeof(int), compareRoomNumber);
+  return count;
+}
+
+// Function to check if heap entry a should sit above b in the top-k heap
+// (the heap root is the worst of the kept rows, so it is the one replaced)
+int queryHeapAbove(const BookingQuery *query, const int keys[], int a, int b)
+{
+  return query->descending ? keys[a] < keys[b] : keys[a] > keys[b];
+}
+
+// Function to run a compiled query.
+// Matching booking indexes are written to results[] (room for roomCount entries) and the count returned.
+// Rows come from the index range of the chosen term when it is selective, otherwise from a scan;
+// either way they are visited in booking order, so the answer does not depend on the path.
+// Without ORDER BY, the scan stops as soon as LIMIT rows are found.
+// With ORDER BY, only the best LIMIT rows are kept in a bounded heap while scanning.
+int runBookingQuery(Room rooms[], int roomCount, const BookingQuery *query, int results[])
+{
+  queryRowsRead = 0;
+  if (query->matchesNothing)
+    return 0;
+
+  int limit = query->limit > 0 ? query->limit : roomCount;
+  int count = 0;
+
+  int *rows = malloc((roomCount > 0 ? roomCount : 1) * sizeof(int));
+  if (rows == NULL)
+    return 0;
+  int rowCount = indexedQueryRows(rooms, roomCount, query, rows);
+  if (rowCount < 0)
+  {
+    rowCount = roomCount; // Scan every booking
+    for (int r = 0; r < roomCount; r++)
+      rows[r] = r;
+  }
+
+  if (query->sortColumn == NULL)
+  {
+    for (int r = 0; r < rowCount && count < limit; r++)
+    {
+      int i = rows[r];
+      queryRowsRead++;
+      if (!rooms[i].isBooked)
+        continue;
+      int t = 0;
+      while (t < query->termCount && query->terms[t].test(&query->terms[t], &rooms[i]))
+        t++;
+      if (t == query->termCount)
+        results[count++] = i;
+    }
+    free(rows);
+    return count;
+  }
+
+  int *keys = malloc((limit > 0 ? limit : 1) * sizeof(int));
+  if (keys == NULL)
+  {
+    free(rows);
+    return 0;
+  }
+
+  // results[0..count) is a heap ordered by keys[], worst kept row at the root
+  for (int r = 0; r < rowCount; r++)
+  {
+    int i = rows[r];
+    queryRowsRead++;
+    if (!rooms[i].isBooked)
+      continue;
+    int t = 0;
+    while (t < query->termCount && query->terms[t].test(&query->terms[t], &rooms[i]))
+      t++;
+    if (t < query->termCount)
+      continue;
+
+    int key = query->sortColumn(&rooms[i]);
+    int pos;
+    if (count < limit)
+    {
+      pos = count++;
+      while (pos > 0)
+      {
+        int parent = (pos - 1) / 2;
+        keys[pos] = key;
+        if (!queryHeapAbove(query, keys, pos, parent))
+          break;
+        keys[pos] = keys[parent];
+        results[pos] = results[parent];
+        pos = parent;
+      }
+    }
+    else
+    {
+      // Replace the root only if the new row beats the worst kept row
+      if (query->descending ? key <= keys[0] : key >= keys[0])
+        continue;
+      pos = 0;
+      while (1)
+      {
+        int child = 2 * pos + 1;
+        if (child >= count)
+          break;
+        if (child + 1 < count && queryHeapAbove(query, keys, child + 1, child))
+          child++;
+        if (query->descending ? key <= keys[child] : key >= keys[child])
+          break;
+        keys[pos] = keys[child];
+        results[pos] = results[child];
+        pos = child;
+      }
+    }
+    keys[pos] = key;
+    results[pos] = i;
+  }
+
+  // Pop the heap from the back to leave results in sorted order
+  for (int end = count - 1; end > 0; end--)
+  {
+    int key = keys[end], index = results[end];
+    keys[end] = keys[0];
+    results[end] = results[0];
+
+    int pos = 0;
+    while (1)
+    {
+      int child = 2 * pos + 1;
+      if (child >= end)
+        break;
+      if (child + 1 < end && queryHeapAbove(query, keys, child + 1, child))
+        child++;
+      if (query->descending ? key <= keys[child] : key >= keys[child])
+        break;
+      keys[pos] = keys[child];
+      results[pos] = results[child];
+      pos = child;
+    }
+    keys[pos] = key;
+    results[pos] = index;
+  }
+
+  free(keys);
+  free(rows);
+  return count;
+}
+
+// Function to read a filter query from the clerk and show the matching bookings
+void filterBookings(Room rooms[], int roomCount)
+{
+  char text[256], error[128];
+  BookingQuery query;
+
+  printf("Fields: room type nights price checkin checkout name contact\n");
+  printf("Example: type=Suite AND checkin>=2026-12-20 AND price>3000 AND name~\"lee\" ORDER BY price DESC LIMIT 10\n");
+  printf("Enter filter: ");
+  if (fgets(text, sizeof(text), stdin) == NULL)
+    return;
+  text[strcspn(text, "\n")] = '\0'; // Remove newline
+
+  if (!compileBookingQuery(text, &query, error, sizeof(error)))
+  {
+    printf("\n==========================================\n");
+    printf("Invalid filter: %s\n", error);
+    printf("==========================================\n");
+    return;
+  }
+
+  int *results = malloc((roomCount > 0 ? roomCount : 1) * sizeof(int));
+  if (results == NULL)
+    return;
+  int count = runBookingQuery(rooms, roomCount, &query, results);
+
+  printf("\n========================== FILTER RESULTS ==========================\n");
+  printf("%-5s %-20s %-15s %-10s %-12s %-12s %-10s\n",
+         "Room", "Guest Name", "Contact", "Type", "Check-in", "Check-out", "Price");
+  printf("--------------------------------------------------------------------\n");
+  for (int i = 0; i < count; i++)
+  {
+    printBookingRow(&rooms[results[i]]);
+  }
+  printf("====================================================================\n");
+  printf("%d booking(s) matched (%d of %d row(s) read).\n", count, queryRowsRead, roomCount);
+
+  free(results);
+}
+
+// Function to write one booking as a single journal record.
+// The guest name goes last because it may contain spaces; an empty contact is written as "-".
+void formatJournalRecord(const Room *room, char *buf, int size)
+{
+  snprintf(buf, size, "%d %d %d %d %d %d %s %s",
+           room->roomNumber,
+           room->roomType,
+           room->nights,
+           (int)(room->totalPrice * 100.0f + 0.5f),
+           room->isBooked,
+           dateToDayNumber(room->checkInDate),
+           room->contact[0] != '\0' ? room->contact : "-",
+           room->guestName);
+}
+
+// Function to read a journal record back into a booking, returns 0 if it is malformed
+int parseJournalRecord(const char *text, Room *room)
+{
+  int roomType, cents, checkIn, consumed = 0;
+  char contact[MAX_CONTACT_LENGTH];
+
+  if (sscanf(text, "%d %d %d %d %d %d %14s %n", &room->roomNumber, &roomType, &room->nights,
+             &cents, &room->isBooked, &checkIn, contact, &consumed) != 7 ||
+      consumed == 0)
+    return 0;
+
+  strcpy(room->contact, strcmp(contact, "-") == 0 ? "" : contact);
+  strncpy(room->guestName, text + consumed, MAX_NAME_LENGTH - 1);
+  room->guestName[MAX_NAME_LENGTH - 1] = '\0';
+  room->guestName[strcspn(room->guestName, "\n")] = '\0'; // Remove newline
+
+  room->bookingId = 0; // Carried next to the record where it matters
+  room->roomType = (RoomType)roomType;
+  room->totalPrice = cents / 100.0f;
+  dayNumberToDate(checkIn, &room->checkInDate);
+  calculateCheckOutDate(&room->checkInDate, &room->checkOutDate, room->nights);
+  return 1;
+}
+
+// Function to format a change as one journal line (without the newline).
+// op is 'A' (add newBooking), 'C' (cancel oldBooking) or 'M' (replace oldBooking with newBooking).
+// Entries name the booking by id ("A id record", "C id", "M id record"), so a swap or chain of
+// room moves written as separate lines cannot be applied to the wrong booking.
+// Returns 0 for a modification that changed nothing, which is not written.
+int formatJournalEntry(char op, const Room *oldBooking, const Room *newBooking, char *line, int size)
+{
+  char oldText[JOURNAL_LINE_LENGTH], newText[JOURNAL_LINE_LENGTH];
+
+  if (newBooking != NULL)
+    formatJournalRecord(newBooking, newText, sizeof(newText));
+  if (op == 'M')
+  {
+    formatJournalRecord(oldBooking, oldText, sizeof(oldText));
+    if (strcmp(oldText, newText) == 0)
+      return 0;
+  }
+
+  switch (op)
+  {
+  case 'A':
+    snprintf(line, size, "A %d %s", newBooking->bookingId, newText);
+    return 1;
+  case 'C':
+    snprintf(line, size, "C %d", oldBooking->bookingId);
+    return 1;
+  case 'M':
+    snprintf(line, size, "M %d %s", oldBooking->bookingId, newText);
+    return 1;
+  }
+  return 0;
+}
+
+// Function to append one formatted line to the journal
+void writeJournalLine(const char *line)
+{
+  if (!journalEnabled)
+    return;
+
+  FILE *file = fopen(JOURNAL_FILE, "a");
+  if (file == NULL)
+    return;
+  fprintf(file, "%s\n", line);
+  fclose(file);
+}
+
+// Function to record a change in the journal, so followers and crash recovery can replay it.
+// The change is also written to the session trace when the session is being recorded.
+void appendJournal(char op, const Room *oldBooking, const Room *newBooking)
+{
+  char line[2 * JOURNAL_LINE_LENGTH];
+
+  if (!formatJournalEntry(op, oldBooking, newBooking, line, sizeof(line)))
+    return;
+  writeJournalLine(line);
+  recordTrace(line);
+
+  // Every journaled change is also the point where cached availability goes stale
+  if (oldBooking != NULL)
+    invalidateAvailability(oldBooking->roomType);
+  if (newBooking != NULL)
+    invalidateAvailability(newBooking->roomType);
+}
+
+// Function to start a new, empty journal after a snapshot has been saved.
+// The generation number in the first line tells followers to reload the snapshot.
+void resetJournal()
+{
+  int generation = 0;
+
+  FILE *file = fopen(JOURNAL_FILE, "r");
+  if (file != NULL)
+  {
+    if (fscanf(file, "G %d", &generation) != 1)
+      generation = 0;
+    fclose(file);
+  }
+
+  file = fopen(JOURNAL_FILE, "w");
+  if (file != NULL)
+  {
+    fprintf(file, "G %d %d\n", generation + 1, JOURNAL_FORMAT_VERSION);
+    fclose(file);
+  }
+}
+
+// Function to find a booking by its id, -1 if not found
+int findBookingById(Room rooms[], int roomCount, int bookingId)
+{
+  for (int i = 0; i < roomCount; i++)
+  {
+    if (rooms[i].bookingId == bookingId)
+      return i;
+  }
+  return -1;
+}
+
+// Function to apply one journal line to a booking list.
+// Applying is idempotent (adds and modifications replace the booking with that id, cancels of
+// missing bookings are ignored), so a line that is already part of the snapshot does no harm
+// if it is read again. Group markers ("[ firstId count", "] firstId") are checked by
+// followJournal and are not change entries here.
+// Returns 1 if the line was a change entry.
+int applyJournalLine(Room rooms[], int *roomCount, const char *line)
+{
+  Room booking;
+  int bookingId, day, consumed = 0, index;
+
+  switch (line[0])
+  {
+  case 'A':
+  case 'M':
+    if (sscanf(line + 1, " %d %n", &bookingId, &consumed) != 1 || consumed == 0 || bookingId <= 0 ||
+        !parseJournalRecord(line + 1 + consumed, &booking))
+      return 0;
+    booking.bookingId = bookingId;
+    if (bookingId >= nextBookingId)
+      nextBookingId = bookingId + 1;
+    index = findBookingById(rooms, *roomCount, bookingId);
+    break;
+
+  case 'N':
+    // Night audit: the business date only moves forward
+    if (sscanf(line, "N %d", &day) != 1)
+      return 0;
+    if (day > businessDay)
+      businessDay = day;
+    return 1;
+
+  case 'C':
+    if (sscanf(line, "C %d", &bookingId) != 1)
+      return 0;
+    index = findBookingById(rooms, *roomCount, bookingId);
+    if (index != -1)
+    {
+      invalidateAvailability(rooms[index].roomType);
+      for (int i = index; i < *roomCount - 1; i++)
+      {
+        rooms[i] = rooms[i + 1];
+      }
+      (*roomCount)--;
+    }
+    return 1;
+
+  default:
+    return 0;
+  }
+
+  if (index != -1)
+  {
+    invalidateAvailability(rooms[index].roomType);
+    rooms[index] = booking;
+  }
+  else if (*roomCount < MAX_BOOKINGS)
+    rooms[(*roomCount)++] = booking;
+  invalidateAvailability(booking.roomType);
+  return 1;
+}
+
+// Function to check the group booking that starts at a "[ firstId count" journal line.
+// The file is positioned just past that line. Returns 1 if all count adds and the closing
+// "] firstId" line follow (the file is left where it was, so the adds can be applied), 0 if the
+// journal ends first (the group is still being written), or -1 if another entry comes before
+// the group is complete (its writer stopped part way; the file is left at that entry).
+int checkJournalGroup(FILE *file, const char *beginLine)
+{
+  char line[JOURNAL_LINE_LENGTH];
+  int firstId, count, bookingId;
+  long groupStart = ftell(file), lineStart = groupStart;
+
+  if (sscanf(beginLine, "[ %d %d", &firstId, &count) != 2 || firstId <= 0 || count < 1)
+    return -1;
+  // Ids of an unfinished group are never handed out again, so its adds cannot be mistaken
+  // for later ones
+  if (firstId + count > nextBookingId)
+    nextBookingId = firstId + count;
+
+  for (int k = 0; k <= count; k++)
+  {
+    if (fgets(line, sizeof(line), file) == NULL || line[strlen(line) - 1] != '\n')
+      return 0;
+    int belongs = k < count ? sscanf(line, "A %d", &bookingId) == 1 && bookingId == firstId + k
+                            : sscanf(line, "] %d", &bookingId) == 1 && bookingId == firstId;
+    if (!belongs)
+    {
+      fseek(file, lineStart, SEEK_SET);
+      return -1;
+    }
+    lineStart = ftell(file);
+  }
+  fseek(file, groupStart, SEEK_SET);
+  return 1;
+}
+
+// Function to bring a booking list up to date with the snapshot and journal on disk.
+// The snapshot is (re)loaded the first time and whenever the primary has saved a new one;
+// after that only journal lines past the reader's offset are applied.
+// Returns the number of journal entries applied.
+int followJournal(Room rooms[], int *roomCount, JournalReader *reader)
+{
+  char line[JOURNAL_LINE_LENGTH];
+  int generation = 0, version = JOURNAL_FORMAT_VERSION;
+  long start = 0;
+
+  FILE *file = fopen(JOURNAL_FILE, "r");
+  if (file != NULL && fgets(line, sizeof(line), file) != NULL && sscanf(line, "G %d", &generation) == 1)
+  {
+    if (sscanf(line, "G %*d %d", &version) != 1)
+      version = 1; // Entries keyed on room and check-in day
+    start = ftell(file);
+  }
+
+  if (!reader->loaded || generation != reader->generation)
+  {
+    *roomCount = 0;
+    loadBookingsFromFile(rooms, roomCount);
+    reader->generation = generation;
+    reader->offset = start;
+    reader->applied = 0;
+    reader->loaded = 1;
+    if (version != JOURNAL_FORMAT_VERSION)
+      printf("Warning: %s was written by an older version; its unsaved changes are not replayed.\n",
+             JOURNAL_FILE);
+  }
+
+  if (file == NULL)
+    return 0;
+  if (version != JOURNAL_FORMAT_VERSION)
+  {
+    fclose(file);
+    return 0;
+  }
+
+  int applied = 0;
+  fseek(file, reader->offset, SEEK_SET);
+  while (fgets(line, sizeof(line), file) != NULL)
+  {
+    // Stop at a line the primary is still writing; it is picked up next time
+    if (line[strlen(line) - 1] != '\n')
+      break;
+    if (line[0] == '[')
+    {
+      // A group booking is applied whole or not at all
+      int group = checkJournalGroup(file, line);
+      if (group == 0)
+        break;
+      if (group < 0)
+      {
+        reader->offset = ftell(file); // Skip the unfinished group
+        continue;
+      }
+    }
+    applied += applyJournalLine(rooms, roomCount, line);
+    reader->offset = ftell(file);
+  }
+
+  fclose(file);
+  reader->applied += applied;
+  return applied;
+}
+
+// Function to display occupancy and revenue per room type
+void displayOccupancyReport(Room rooms[], int roomCount)
+{
+  int bookings[MAX_ROOM_TYPES + 1] = {0};
+  int roomNights[MAX_ROOM_TYPES + 1] = {0};
+  float revenue[MAX_ROOM_TYPES + 1] = {0};
+  int totalBookings = 0, totalNights = 0;
+  float totalRevenue = 0;
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    if (!rooms[i].isBooked || !isValidRoomType(rooms[i].roomType))
+      continue;
+    bookings[rooms[i].roomType]++;
+    roomNights[rooms[i].roomType] += rooms[i].nights;
+    revenue[rooms[i].roomType] += rooms[i].totalPrice;
+  }
+
+  printf("\n===================== OCCUPANCY REPORT =====================\n");
+  printf("%-10s %-10s %-12s %-14s %-10s\n", "Type", "Bookings", "Room-nights", "Revenue", "Avg/night");
+  printf("------------------------------------------------------------\n");
+  for (int type = 1; type <= inventory.typeCount; type++)
+  {
+    printf("%-10s %-10d %-12d $%-13.2f $%-9.2f\n", getRoomTypeName(type), bookings[type],
+           roomNights[type], revenue[type], roomNights[type] > 0 ? revenue[type] / roomNights[type] : 0.0f);
+    totalBookings += bookings[type];
+    totalNights += roomNights[type];
+    totalRevenue += revenue[type];
+  }
+  printf("------------------------------------------------------------\n");
+  printf("%-10s %-10d %-12d $%-13.2f\n", "Total", totalBookings, totalNights, totalRevenue);
+  printf("============================================================\n");
+}
+
+// Function to run as a read-only follower (started with --follower).
+// The follower serves listings, searches and reports from its own copy of the store,
+// catching up on the primary's journal right before each request, and never writes.
+int runFollower()
+{
+  static Room rooms[MAX_BOOKINGS];
+  int roomCount = 0;
+  JournalReader journal = {0};
+
+  followJournal(rooms, &roomCount, &journal);
+
+  while (1)
+  {
+    system("cls"); // Clear screen before showing menu
+    printf("\n===== RASA RIA HOTEL SERVICES (READ-ONLY FOLLOWER) =====\n");
+    printf("1. Display All Bookings\n");
+    printf("2. Search for a Booking\n");
+    printf("3. Occupancy Report\n");
+    printf("4. Exit\n");
+    printf("========================================================\n");
+    int choice = getValidInteger("Enter your choice: ");
+
+    if (choice >= 1 && choice <= 3)
+    {
+      followJournal(rooms, &roomCount, &journal);
+      printf("(Snapshot generation %d + %d journal change(s))\n", journal.generation, journal.applied);
+    }
+
+    switch (choice)
+    {
+    case 1:
+      displayBookings(rooms, roomCount);
+      break;
+    case 2:
+      searchBooking(rooms, roomCount);
+      break;
+    case 3:
+      displayOccupancyReport(rooms, roomCount);
+      break;
+    case 4:
+      return 0;
+    default:
+      printf("\n================================================\n");
+      printf("Invalid choice. Please enter a number from 1 to 4.\n");
+      printf("================================================\n");
+    }
+    printf("\nPress Enter to continue...");
+    getchar();
+  }
+}
+
+// Function to swap two slots of the check-out heap, keeping the position map in step
+void swapCheckoutSlots(int a, int b)
+{
+  int index = checkoutHeap[a];
+  int key = checkoutHeapKey[a];
+
+  checkoutHeap[a] = checkoutHeap[b];
+  checkoutHeapKey[a] = checkoutHeapKey[b];
+  checkoutHeap[b] = index;
+  checkoutHeapKey[b] = key;
+
+  checkoutHeapPos[checkoutHeap[a]] = a;
+  checkoutHeapPos[checkoutHeap[b]] = b;
+}
+
+// Function to move a heap slot up while its check-out is earlier than its parent's
+void siftCheckoutUp(int slot)
+{
+  while (slot > 0)
+  {
+    int parent = (slot - 1) / 2;
+    if (checkoutHeapKey[parent] <= checkoutHeapKey[slot])
+      break;
+    swapCheckoutSlots(slot, parent);
+    slot = parent;
+  }
+}
+
+// Function to move a heap slot down while a child checks out earlier
+void siftCheckoutDown(int slot)
+{
+  while (1)
+  {
+    int child = 2 * slot + 1;
+    if (child >= checkoutHeapSize)
+      break;
+    if (child + 1 < checkoutHeapSize && checkoutHeapKey[child + 1] < checkoutHeapKey[child])
+      child++;
+    if (checkoutHeapKey[slot] <= checkoutHeapKey[child])
+      break;
+    swapCheckoutSlots(slot, child);
+    slot = child;
+  }
+}
+
+// Function to take one slot out of the check-out heap
+void removeCheckoutSlot(int slot)
+{
+  int last = --checkoutHeapSize;
+
+  checkoutHeapPos[checkoutHeap[slot]] = -1;
+  if (slot == last)
+    return;
+
+  int moved = checkoutHeap[last];
+  checkoutHeap[slot] = moved;
+  checkoutHeapKey[slot] = checkoutHeapKey[last];
+  checkoutHeapPos[moved] = slot;
+  siftCheckoutUp(slot);
+  siftCheckoutDown(checkoutHeapPos[moved]);
+}
+
+// Function to rebuild the check-out heap from the booking list (after loading or removing bookings)
+void rebuildCheckoutHeap(Room rooms[], int roomCount)
+{
+  for (int i = 0; i < MAX_BOOKINGS; i++)
+    checkoutHeapPos[i] = -1;
+
+  checkoutHeapSize = 0;
+  for (int i = 0; i < roomCount; i++)
+  {
+    if (!rooms[i].isBooked)
+      continue;
+    checkoutHeap[checkoutHeapSize] = i;
+    checkoutHeapKey[checkoutHeapSize] = dateToDayNumber(rooms[i].checkInDate) + rooms[i].nights;
+    checkoutHeapPos[i] = checkoutHeapSize;
+    checkoutHeapSize++;
+  }
+
+  // Bottom-up heapify, O(N)
+  for (int slot = checkoutHeapSize / 2 - 1; slot >= 0; slot--)
+    siftCheckoutDown(slot);
+}
+
+// Function to add, re-key or drop one booking in the check-out heap after it was added or modified
+void trackCheckout(Room rooms[], int index)
+{
+  int slot = checkoutHeapPos[index];
+
+  if (!rooms[index].isBooked)
+  {
+    if (slot != -1)
+      removeCheckoutSlot(slot);
+    return;
+  }
+
+  if (slot == -1)
+  {
+    slot = checkoutHeapSize++;
+    checkoutHeap[slot] = index;
+    checkoutHeapPos[index] = slot;
+  }
+  checkoutHeapKey[slot] = dateToDayNumber(rooms[index].checkInDate) + rooms[index].nights;
+  siftCheckoutUp(slot);
+  siftCheckoutDown(checkoutHeapPos[index]);
+}
+
+// Function to release every stay that has ended by the new business date.
+// Only the heap top is examined, so the cost is O(k log N) for k ended stays.
+// Released stays stop blocking their room straight away. There is no arrival status, so a
+// no-show is released at its booked check-out like any other stay, not early.
+// The new date is journaled ("N day") after the releases, so it survives a restart.
+// The indexes of released bookings go to releasedIndexes[] unless it is NULL.
+// Returns the number of stays released.
+int releaseEndedStays(Room rooms[], int newBusinessDay, int releasedIndexes[])
+{
+  char line[2 * JOURNAL_LINE_LENGTH];
+  int released = 0;
+
+  while (checkoutHeapSize > 0 && checkoutHeapKey[0] <= newBusinessDay)
+  {
+    int index = checkoutHeap[0];
+    removeCheckoutSlot(0);
+
+    Room before = rooms[index];
+    rooms[index].isBooked = 0;
+    if (formatJournalEntry('M', &before, &rooms[index], line, sizeof(line)))
+      writeJournalLine(line);
+    invalidateAvailability(rooms[index].roomType);
+
+    if (releasedIndexes != NULL)
+      releasedIndexes[released] = index;
+    released++;
+  }
+
+  businessDay = newBusinessDay;
+  snprintf(line, sizeof(line), "N %d", businessDay);
+  writeJournalLine(line);
+  return released;
+}
+
+// Function to run the night audit: advance the business date and release ended stays
+void nightAudit(Room rooms[])
+{
+  Date newDate;
+
+  printf("\n=== NIGHT AUDIT ===\n");
+  if (businessDay > 0)
+  {
+    Date current;
+    dayNumberToDate(businessDay, &current);
+    printf("Current business date: %02d/%02d/%04d\n", current.day, current.month, current.year);
+  }
+
+  newDate.day = getValidInteger("New business date - day (DD): ");
+  newDate.month = getValidInteger("New business date - month (MM): ");
+  newDate.year = getValidInteger("New business date - year (YYYY): ");
+  if (!isDateValid(newDate))
+  {
+    printf("Invalid date. Night audit canceled.\n");
+    return;
+  }
+  lockBookingStore();
+  if (dateToDayNumber(newDate) < businessDay)
+  {
+    unlockBookingStore(0);
+    printf("The business date cannot move backwards. Night audit canceled.\n");
+    return;
+  }
+
+  printf("\n=============== RELEASED STAYS ===============\n");
+  printf("%-5s %-20s %-12s %-12s\n", "Room", "Guest Name", "Check-in", "Check-out");
+  printf("----------------------------------------------\n");
+  static int releasedIndexes[MAX_BOOKINGS];
+  int released = releaseEndedStays(rooms, dateToDayNumber(newDate), releasedIndexes);
+  for (int i = 0; i < released; i++)
+  {
+    const Room *room = &rooms[releasedIndexes[i]];
+    printf("%-5d %-20s %02d/%02d/%04d  %02d/%02d/%04d\n", room->roomNumber, room->guestName,
+           room->checkInDate.day, room->checkInDate.month, room->checkInDate.year,
+           room->checkOutDate.day, room->checkOutDate.month, room->checkOutDate.year);
+  }
+  printf("==============================================\n");
+
+  // The session trace keeps the audit as one request; its releases are replayed by the heap
+  char line[32];
+  snprintf(line, sizeof(line), "N %d", businessDay);
+  recordTrace(line);
+  unlockBookingStore(1);
+  printf("%d stay(s) released. Business date is now %02d/%02d/%04d.\n",
+         released, newDate.day, newDate.month, newDate.year);
+  if (released > 0)
+  {
+    printf("Released stays can be moved to the archive from Archive & Stay History.\n");
+  }
+}
+
+// Function to write a 32-bit integer in little-endian byte order
+void writeInt32(FILE *file, int value)
+{
+  unsigned int v = (unsigned int)value;
+  fputc(v & 0xFF, file);
+  fputc((v >> 8) & 0xFF, file);
+  fputc((v >> 16) & 0xFF, file);
+  fputc((v >> 24) & 0xFF, file);
+}
+
+// Function to start an empty row group
+void resetColumnarGroup(ColumnarWriter *writer)
+{
+  writer->rows = 0;
+  writer->roomLength = writer->checkInLength = writer->nightsLength = 0;
+  writer->priceLength = writer->nameLength = 0;
+  writer->prevCheckIn = 0;
+  writer->minRoom = writer->minCheckIn = writer->minCheckOut = writer->minPrice = INT_MAX;
+  writer->maxRoom = writer->maxCheckIn = writer->maxCheckOut = writer->maxPrice = INT_MIN;
+  writer->dictionaryCount = 0;
+  for (int i = 0; i < EXPORT_DICT_SLOTS; i++)
+    writer->dictionarySlots[i] = -1;
+}
+
+// Function to write the buffered row group to the export file.
+//
+// Row group layout (all int32 little-endian):
+//   "RGRP", row count, byte length of everything after this field,
+//   min/max room, min/max check-in, min/max check-out, min/max price (cents),
+//   dictionary: entry count, byte length, then (varint length, bytes) per guest name,
+//   six columns, each as byte length + data, in the order
+//   room (varint), type (1 byte), check-in (zigzag varint delta), nights (varint),
+//   price in cents (varint), guest name (varint dictionary id).
+// Readers can test the statistics and skip the whole group using its byte length.
+int flushColumnarGroup(ColumnarWriter *writer)
+{
+  if (writer->rows == 0)
+    return 1;
+
+  int dictionaryBytes = 0;
+  for (int i = 0; i < writer->dictionaryCount; i++)
+  {
+    unsigned char lengthBytes[5];
+    int length = strlen(writer->dictionary[i]);
+    dictionaryBytes += putVarint(lengthBytes, (unsigned int)length) + length;
+  }
+
+  int groupBytes = 8 * 4 + 2 * 4 + dictionaryBytes + 6 * 4 +
+                   writer->roomLength + writer->rows + writer->checkInLength +
+                   writer->nightsLength + writer->priceLength + writer->nameLength;
+
+  fwrite("RGRP", 1, 4, writer->file);
+  writeInt32(writer->file, writer->rows);
+  writeInt32(writer->file, groupBytes);
+  writeInt32(writer->file, writer->minRoom);
+  writeInt32(writer->file, writer->maxRoom);
+  writeInt32(writer->file, writer->minCheckIn);
+  writeInt32(writer->file, writer->maxCheckIn);
+  writeInt32(writer->file, writer->minCheckOut);
+  writeInt32(writer->file, writer->maxCheckOut);
+  writeInt32(writer->file, writer->minPrice);
+  writeInt32(writer->file, writer->maxPrice);
+
+  writeInt32(writer->file, writer->dictionaryCount);
+  writeInt32(writer->file, dictionaryBytes);
+  for (int i = 0; i < writer->dictionaryCount; i++)
+  {
+    unsigned char lengthBytes[5];
+    int length = strlen(writer->dictionary[i]);
+    fwrite(lengthBytes, 1, putVarint(lengthBytes, (unsigned int)length), writer->file);
+    fwrite(writer->dictionary[i], 1, length, writer->file);
+  }
+
+  writeInt32(writer->file, writer->roomLength);
+  fwrite(writer->room, 1, writer->roomLength, writer->file);
+  writeInt32(writer->file, writer->rows);
+  fwrite(writer->type, 1, writer->rows, writer->file);
+  writeInt32(writer->file, writer->checkInLength);
+  fwrite(writer->checkIn, 1, writer->checkInLength, writer->file);
+  writeInt32(writer->file, writer->nightsLength);
+  fwrite(writer->nights, 1, writer->nightsLength, writer->file);
+  writeInt32(writer->file, writer->priceLength);
+  fwrite(writer->price, 1, writer->priceLength, writer->file);
+  writeInt32(writer->file, writer->nameLength);
+  fwrite(writer->name, 1, writer->nameLength, writer->file);
+
+  writer->groups++;
+  resetColumnarGroup(writer);
+  return !ferror(writer->file);
+}
+
+// Function to append one stay to the current row group, flushing it when full
+int addColumnarRow(ColumnarWriter *writer, const Room *room)
+{
+  int checkIn = dateToDayNumber(room->checkInDate);
+  int checkOut = checkIn + room->nights;
+  int cents = (int)(room->totalPrice * 100.0f + 0.5f);
+  int delta = checkIn - writer->prevCheckIn;
+
+  // Look the guest name up in the group dictionary (FNV-1a hash, linear probing)
+  unsigned int hash = 2166136261u;
+  for (const char *c = room->guestName; *c != '\0'; c++)
+    hash = (hash ^ (unsigned char)*c) * 16777619u;
+  int slot = hash % EXPORT_DICT_SLOTS;
+  while (writer->dictionarySlots[slot] != -1 &&
+         strcmp(writer->dictionary[writer->dictionarySlots[slot]], room->guestName) != 0)
+    slot = (slot + 1) % EXPORT_DICT_SLOTS;
+  if (writer->dictionarySlots[slot] == -1)
+  {
+    strcpy(writer->dictionary[writer->dictionaryCount], room->guestName);
+    writer->dictionarySlots[slot] = writer->dictionaryCount++;
+  }
+
+  writer->roomLength += putVarint(writer->room + writer->roomLength, (unsigned int)room->roomNumber);
+  writer->type[writer->rows] = (unsigned char)room->roomType;
+  writer->checkInLength += putVarint(writer->checkIn + writer->checkInLength,
+                                     delta >= 0 ? (unsigned int)delta * 2 : (unsigned int)(-delta) * 2 - 1);
+  writer->nightsLength += putVarint(writer->nights + writer->nightsLength, (unsigned int)room->nights);
+  writer->priceLength += putVarint(writer->price + writer->priceLength, (unsigned int)cents);
+  writer->nameLength += putVarint(writer->name + writer->nameLength, (unsigned int)writer->dictionarySlots[slot]);
+  writer->prevCheckIn = checkIn;
+
+  if (room->roomNumber < writer->minRoom)
+    writer->minRoom = room->roomNumber;
+  if (room->roomNumber > writer->maxRoom)
+    writer->maxRoom = room->roomNumber;
+  if (checkIn < writer->minCheckIn)
+    writer->minCheckIn = checkIn;
+  if (checkIn > writer->maxCheckIn)
+    writer->maxCheckIn = checkIn;
+  if (checkOut < writer->minCheckOut)
+    writer->minCheckOut = checkOut;
+  if (checkOut > writer->maxCheckOut)
+    writer->maxCheckOut = checkOut;
+  if (cents < writer->minPrice)
+    writer->minPrice = cents;
+  if (cents > writer->maxPrice)
+    writer->maxPrice = cents;
+
+  writer->rows++;
+  writer->totalRows++;
+  writer->checksum += columnarRowHash(room);
+  if (writer->rows == EXPORT_ROWS_PER_GROUP)
+    return flushColumnarGroup(writer);
+  return 1;
+}
+
+// Function to stream every archived stay into the export, one archive block at a time
+int exportArchivedStays(ColumnarWriter *writer)
+{
+  FILE *index = archiveCommittedBlocks > 0 ? openArchiveIndex("rb") : NULL;
+  FILE *archive = fopen(ARCHIVE_FILE, "rb");
+  int ok = 1;
+
+  if (index == NULL || archive == NULL)
+  {
+    if (index != NULL)
+      fclose(index);
+    if (archive != NULL)
+      fclose(archive);
+    return 1; // Nothing archived yet
+  }
+
+  Room stays[ARCHIVE_BLOCK_RECORDS];
+  ArchiveIndexEntry entry;
+  for (int b = 0; ok && b < archiveCommittedBlocks && readArchiveIndexEntry(index, &entry); b++)
+  {
+    int count = readArchiveBlock(archive, &entry, stays);
+    if (count != entry.count)
+    {
+      ok = 0; // Corrupt or short block: fail the export rather than drop its stays
+      break;
+    }
+    for (int i = 0; i < count && ok; i++)
+      ok = addColumnarRow(writer, &stays[i]);
+  }
+
+  fclose(index);
+  fclose(archive);
+  return ok;
+}
+
+// Function to export archived and current stays as a column-oriented file.
+// File layout: 8-byte magic "RRCOLv1\0", then row groups of up to EXPORT_ROWS_PER_GROUP
+// stays (see flushColumnarGroup). Columns are varint, delta and dictionary encoded; there is
+// no general-purpose compression on top.
+// The file is written under a temporary name, read back and checked against what was written,
+// and only then renamed over path, so a failed export never replaces a good one.
+// Returns the number of stays written, or -1 on error.
+long exportColumnar(Room rooms[], int roomCount, const char *path)
+{
+  char tempPath[1024];
+  snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+  ColumnarWriter *writer = malloc(sizeof(ColumnarWriter));
+  if (writer == NULL)
+    return -1;
+
+  writer->file = fopen(tempPath, "wb");
+  if (writer->file == NULL)
+  {
+    free(writer);
+    return -1;
+  }
+  writer->totalRows = 0;
+  writer->groups = 0;
+  writer->checksum = 0;
+  resetColumnarGroup(writer);
+
+  fwrite("RRCOLv1\0", 1, 8, writer->file);
+  int ok = exportArchivedStays(writer);
+  for (int i = 0; i < roomCount && ok; i++)
+  {
+    ok = addColumnarRow(writer, &rooms[i]);
+  }
+  if (ok)
+    ok = flushColumnarGroup(writer);
+
+  if (fclose(writer->file) != 0)
+    ok = 0;
+  long total = writer->totalRows;
+  unsigned long long written = writer->checksum;
+  free(writer);
+
+  // Verify: every row must decode to what was written
+  unsigned long long readBack = 0;
+  if (ok && (readColumnar(tempPath, addColumnarChecksum, &readBack) != total || readBack != written))
+    ok = 0;
+
+#ifdef _WIN32
+  if (ok)
+    remove(path); // rename() does not replace an existing file on Windows
+#endif
+  if (!ok || rename(tempPath, path) != 0)
+  {
+    remove(tempPath);
+    return -1;
+  }
+  return total;
+}
+
+// Function to hash the exported fields of one stay (FNV-1a); export checksums add these up,
+// so they do not depend on row order
+unsigned long long columnarRowHash(const Room *stay)
+{
+  char text[JOURNAL_LINE_LENGTH];
+  unsigned long long hash = 14695981039346656037ULL;
+
+  snprintf(text, sizeof(text), "%d %d %d %d %d %s", stay->roomNumber, stay->roomType,
+           dateToDayNumber(stay->checkInDate), stay->nights, (int)(stay->totalPrice * 100.0f + 0.5f),
+           stay->guestName);
+  for (const char *c = text; *c != '\0'; c++)
+  {
+    hash ^= (unsigned char)*c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Function to add one stay to a running export checksum (a readColumnar visitor)
+void addColumnarChecksum(const Room *stay, void *context)
+{
+  *(unsigned long long *)context += columnarRowHash(stay);
+}
+
+// Function to read a 32-bit little-endian integer from a buffer, returns 0 if the buffer runs out
+int getInt32(const unsigned char *buf, int *pos, int len, int *value)
+{
+  if (*pos + 4 > len)
+    return 0;
+  *value = (int)((unsigned int)buf[*pos] | (unsigned int)buf[*pos + 1] << 8 | (unsigned int)buf[*pos + 2] << 16 |
+                 (unsigned int)buf[*pos + 3] << 24);
+  *pos += 4;
+  return 1;
+}
+
+// Function to decode one row group (everything after its byte length) and visit its rows.
+// The group's min/max statistics must match the decoded rows. Returns 0 if the group is corrupt.
+int decodeColumnarGroup(const unsigned char *group, int length, int rows, char dictionary[][MAX_NAME_LENGTH],
+                        void (*visit)(const Room *stay, void *context), void *context)
+{
+  int pos = 0, stats[8], dictionaryCount, dictionaryBytes;
+
+  for (int i = 0; i < 8; i++)
+  {
+    if (!getInt32(group, &pos, length, &stats[i]))
+      return 0;
+  }
+  if (!getInt32(group, &pos, length, &dictionaryCount) || !getInt32(group, &pos, length, &dictionaryBytes) ||
+      dictionaryCount < 0 || dictionaryCount > rows || dictionaryBytes < 0 || pos + dictionaryBytes > length)
+    return 0;
+
+  int dictionaryEnd = pos + dictionaryBytes;
+  for (int i = 0; i < dictionaryCount; i++)
+  {
+    unsigned int nameLength;
+    if (!getVarint(group, &pos, dictionaryEnd, &nameLength) || nameLength >= MAX_NAME_LENGTH ||
+        pos + (int)nameLength > dictionaryEnd)
+      return 0;
+    memcpy(dictionary[i], group + pos, nameLength);
+    dictionary[i][nameLength] = '\0';
+    pos += nameLength;
+  }
+  if (pos != dictionaryEnd)
+    return 0;
+
+  // Column order: room, type, check-in, nights, price, guest name
+  int columnStart[6], columnEnd[6];
+  for (int c = 0; c < 6; c++)
+  {
+    int columnLength;
+    if (!getInt32(group, &pos, length, &columnLength) || columnLength < 0 || pos + columnLength > length)
+      return 0;
+    columnStart[c] = pos;
+    pos += columnLength;
+    columnEnd[c] = pos;
+  }
+  if (pos != length || columnEnd[1] - columnStart[1] != rows)
+    return 0;
+
+  int minRoom = INT_MAX, maxRoom = INT_MIN, minCheckIn = INT_MAX, maxCheckIn = INT_MIN;
+  int minCheckOut = INT_MAX, maxCheckOut = INT_MIN, minPrice = INT_MAX, maxPrice = INT_MIN;
+  int prevCheckIn = 0;
+  for (int r = 0; r < rows; r++)
+  {
+    unsigned int roomNumber, delta, nights, cents, nameId;
+    Room stay;
+
+    if (!getVarint(group, &columnStart[0], columnEnd[0], &roomNumber) ||
+        !getVarint(group, &columnStart[2], columnEnd[2], &delta) ||
+        !getVarint(group, &columnStart[3], columnEnd[3], &nights) ||
+        !getVarint(group, &columnStart[4], columnEnd[4], &cents) ||
+        !getVarint(group, &columnStart[5], columnEnd[5], &nameId) || nameId >= (unsigned)dictionaryCount)
+      return 0;
+
+    int checkIn = prevCheckIn + ((delta & 1) ? -(int)((delta + 1) / 2) : (int)(delta / 2));
+    prevCheckIn = checkIn;
+
+    memset(&stay, 0, sizeof(stay));
+    stay.roomNumber = (int)roomNumber;
+    stay.roomType = (RoomType)group[columnStart[1]++];
+    stay.nights = (int)nights;
+    stay.totalPrice = cents / 100.0f;
+    stay.isBooked = 1;
+    strcpy(stay.guestName, dictionary[nameId]);
+    dayNumberToDate(checkIn, &stay.checkInDate);
+    calculateCheckOutDate(&stay.checkInDate, &stay.checkOutDate, stay.nights);
+
+    int checkOut = checkIn + (int)nights;
+    if ((int)roomNumber < minRoom)
+      minRoom = (int)roomNumber;
+    if ((int)roomNumber > maxRoom)
+      maxRoom = (int)roomNumber;
+    if (checkIn < minCheckIn)
+      minCheckIn = checkIn;
+    if (checkIn > maxCheckIn)
+      maxCheckIn = checkIn;
+    if (checkOut < minCheckOut)
+      minCheckOut = checkOut;
+    if (checkOut > maxCheckOut)
+      maxCheckOut = checkOut;
+    if ((int)cents < minPrice)
+      minPrice = (int)cents;
+    if ((int)cents > maxPrice)
+      maxPrice = (int)cents;
+
+    visit(&stay, context);
+  }
+
+  // Every column must be used up exactly, and the statistics must describe the rows
+  for (int c = 0; c < 6; c++)
+  {
+    if (columnStart[c] != columnEnd[c])
+      return 0;
+  }
+  return stats[0] == minRoom && stats[1] == maxRoom && stats[2] == minCheckIn && stats[3] == maxCheckIn &&
+         stats[4] == minCheckOut && stats[5] == maxCheckOut && stats[6] == minPrice && stats[7] == maxPrice;
+}
+
+// Function to read a columnar export back, calling visit() for every stay in file order.
+// Stays carry the exported fields only (no contact number; isBooked is set).
+// Returns the number of stays read, or -1 if the file is missing, truncated or corrupt.
+long readColumnar(const char *path, void (*visit)(const Room *stay, void *context), void *context)
+{
+  char magic[8], tag[4];
+  unsigned char *group = malloc(EXPORT_MAX_GROUP_BYTES);
+  char(*dictionary)[MAX_NAME_LENGTH] = malloc(EXPORT_ROWS_PER_GROUP * sizeof(*dictionary));
+  FILE *file = fopen(path, "rb");
+  long total = 0;
+
+  int ok = file != NULL && group != NULL && dictionary != NULL && fread(magic, 1, 8, file) == 8 &&
+           memcmp(magic, "RRCOLv1\0", 8) == 0;
+  while (ok)
+  {
+    int rows, groupBytes;
+    size_t tagBytes = fread(tag, 1, 4, file);
+    if (tagBytes == 0 && feof(file))
+      break; // Clean end of file
+    ok = tagBytes == 4 && memcmp(tag, "RGRP", 4) == 0 && readInt32(file, &rows) && readInt32(file, &groupBytes) &&
+         rows > 0 && rows <= EXPORT_ROWS_PER_GROUP && groupBytes > 0 && groupBytes <= EXPORT_MAX_GROUP_BYTES &&
+         fread(group, 1, groupBytes, file) == (size_t)groupBytes &&
+         decodeColumnarGroup(group, groupBytes, rows, dictionary, visit, context);
+    total += rows;
+  }
+
+  if (file != NULL)
+    fclose(file);
+  free(group);
+  free(dictionary);
+  return ok ? total : -1;
+}
+
+// Function to check an export file from the command line (--verify-export).
+// Returns 0 if every row group decodes and matches its statistics.
+int verifyColumnarExport(const char *path)
+{
+  unsigned long long checksum = 0;
+  long stays = readColumnar(path, addColumnarChecksum, &checksum);
+
+  if (stays < 0)
+  {
+    printf("Error: %s is missing, truncated or corrupt.\n", path);
+    return 1;
+  }
+  printf("%s: %ld stay(s) verified, checksum %016llx.\n", path, stays, checksum);
+  return 0;
+}
+
+// Function to read a monotonic clock in microseconds
+long long getMicroseconds()
+{
+#ifdef _WIN32
+  LARGE_INTEGER counter, frequency;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&frequency);
+  return (long long)(counter.QuadPart * 1000000.0 / frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (long long)now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+#endif
+}
+
+// Function to wait for the given number of microseconds
+void sleepMicroseconds(long long micros)
+{
+  if (micros <= 0)
+    return;
+#ifdef _WIN32
+  Sleep((DWORD)(micros / 1000));
+#else
+  struct timespec wait;
+  wait.tv_sec = micros / 1000000;
+  wait.tv_nsec = (micros % 1000000) * 1000;
+  nanosleep(&wait, NULL);
+#endif
+}
+
+// Function to add one operation to the session trace, stamped with the time since recording started.
+// Does nothing when the session is not being recorded.
+void recordTrace(const char *line)
+{
+  if (traceFile == NULL)
+    return;
+  fprintf(traceFile, "%lld %s\n", getMicroseconds() - traceStartMicros, line);
+  fflush(traceFile); // A crashed session still leaves a usable trace
+}
+
+// Function to start recording the session to a trace file (started with --record).
+//
+// Trace layout, one text line each:
+//   "T 4"                         trace format version (TRACE_FORMAT_VERSION)
+//   "B <id> <record>"             bookings already in the store when recording started
+//   "D <day>"                     business date when recording started
+//   "I <id>"                      next booking id when recording started
+//   "<micros> <operation>"        one line per request: "A <id> <must> <prefer> <record>" for an add,
+//                                 a journal entry for a cancel or move (C/M),
+//                                 "G <rooms> <must> <record>" for a group booking,
+//                                 "N <day>" for a night audit or "V <day>" for archiving
+//   "E <checksum> <count>"        final state when the session was saved
+// Adds and group bookings are replayed through the room allocation, so a changed engine
+// shows up as a checksum mismatch. Returns 0 if the file cannot be created.
+int startTraceRecording(Room rooms[], int roomCount, const char *path)
+{
+  char record[JOURNAL_LINE_LENGTH];
+
+  traceFile = fopen(path, "w");
+  if (traceFile == NULL)
+    return 0;
+
+  fprintf(traceFile, "T %d\n", TRACE_FORMAT_VERSION);
+  for (int i = 0; i < roomCount; i++)
+  {
+    formatJournalRecord(&rooms[i], record, sizeof(record));
+    fprintf(traceFile, "B %d %s\n", rooms[i].bookingId, record);
+  }
+  fprintf(traceFile, "D %d\n", businessDay);
+  fprintf(traceFile, "I %d\n", nextBookingId);
+  fflush(traceFile);
+
+  traceStartMicros = getMicroseconds();
+  return 1;
+}
+
+// Function to close the session trace with the checksum of the final booking store
+void finishTraceRecording(Room rooms[], int roomCount)
+{
+  if (traceFile == NULL)
+    return;
+  fprintf(traceFile, "E %llu %d\n", bookingStoreChecksum(rooms, roomCount), roomCount);
+  fclose(traceFile);
+  traceFile = NULL;
+}
+
+// Function to compute a checksum of the booking store.
+// Each booking's journal record is hashed (FNV-1a) and the hashes are added up,
+// so the result does not depend on the order of the bookings in the array.
+unsigned long long bookingStoreChecksum(Room rooms[], int roomCount)
+{
+  char record[JOURNAL_LINE_LENGTH];
+  unsigned long long checksum = 0;
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    unsigned long long hash = 14695981039346656037ULL;
+    formatJournalRecord(&rooms[i], record, sizeof(record));
+    for (const char *c = record; *c != '\0'; c++)
+    {
+      hash ^= (unsigned char)*c;
+      hash *= 1099511628211ULL;
+    }
+    checksum += hash;
+  }
+  return checksum;
+}
+
+// Comparison function for sorting latencies
+int compareLatency(const void *a, const void *b)
+{
+  long long x = *(const long long *)a;
+  long long y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+// Function to run one traced operation against the booking store.
+// refused is increased for an add or group booking that no longer fits.
+// Returns 0 if the operation is not recognised.
+int replayTraceOperation(Room rooms[], int *roomCount, const char *op, int *refused)
+{
+  Room booking;
+  int value, consumed = 0;
+
+  switch (op[0])
+  {
+  case 'A':
+  {
+    unsigned int mustHave, prefer;
+    if (sscanf(op, "A %d %u %u %n", &value, &mustHave, &prefer, &consumed) != 3 || consumed == 0 ||
+        !parseJournalRecord(op + consumed, &booking))
+      return 0;
+    booking.bookingId = value; // The recorded id, so later cancels and moves find the booking
+    if (value >= nextBookingId)
+      nextBookingId = value + 1;
+    // Ask the allocator again, with the recorded features, rather than trusting the recorded room
+    int roomNumber = *roomCount < MAX_BOOKINGS
+                         ? assignMatchingRoom(rooms, *roomCount, booking.roomType, booking.checkInDate, booking.nights,
+                                              -1, mustHave, prefer)
+                         : -1;
+    if (roomNumber == -1)
+    {
+      (*refused)++;
+      return 1;
+    }
+    booking.roomNumber = roomNumber;
+    insertBooking(rooms, roomCount, &booking, mustHave, prefer);
+    return 1;
+  }
+
+  case 'G':
+  {
+    int roomNumbers[MAX_ROOMS];
+    unsigned int mustHave;
+    if (sscanf(op, "G %d %u %n", &value, &mustHave, &consumed) != 2 || consumed == 0 || value < 1 ||
+        value > MAX_ROOMS || !parseJournalRecord(op + consumed, &booking))
+      return 0;
+    if (!bookRoomBlock(rooms, roomCount, &booking, value, mustHave, roomNumbers))
+      (*refused)++;
+    return 1;
+  }
+
+  case 'C':
+  {
+    if (sscanf(op, "C %d", &value) != 1)
+      return 0;
+    int index = findBookingById(rooms, *roomCount, value);
+    if (index == -1)
+      (*refused)++; // The booking was itself refused earlier in the replay
+    else
+      cancelBookingAt(rooms, roomCount, index);
+    return 1;
+  }
+
+  case 'M':
+  {
+    if (sscanf(op, "M %d %n", &value, &consumed) != 1 || consumed == 0 || !parseJournalRecord(op + consumed, &booking))
+      return 0;
+    int index = findBookingById(rooms, *roomCount, value);
+    if (index == -1)
+    {
+      (*refused)++;
+      return 1;
+    }
+    booking.bookingId = value;
+    // Keep the recorded room if it is still free, otherwise ask the allocator like the modify screen does
+    if (!isRoomFree(rooms, *roomCount, booking.roomNumber, booking.checkInDate, booking.nights, index))
+    {
+      int roomNumber = assignRoomNumber(rooms, *roomCount, booking.roomType, booking.checkInDate, booking.nights, index);
+      if (roomNumber == -1)
+      {
+        (*refused)++;
+        return 1;
+      }
+      booking.roomNumber = roomNumber;
+    }
+    updateBookingAt(rooms, index, &booking);
+    return 1;
+  }
+
+  case 'N':
+    if (sscanf(op, "N %d", &value) != 1)
+      return 0;
+    releaseEndedStays(rooms, value, NULL);
+    return 1;
+
+  case 'V':
+  {
+    // Archiving only removes completed stays from the store; a replay never writes the archive
+    if (sscanf(op, "V %d", &value) != 1)
+      return 0;
+    int kept = 0;
+    for (int i = 0; i < *roomCount; i++)
+    {
+      if (dateToDayNumber(rooms[i].checkOutDate) >= value)
+        rooms[kept++] = rooms[i];
+    }
+    *roomCount = kept;
+    rebuildCheckoutHeap(rooms, *roomCount);
+    invalidateAllAvailability();
+    return 1;
+  }
+
+  default:
+    return 0;
+  }
+}
+
+// Function to replay a recorded session as a load test (started with --replay).
+// speed is 1 for the recorded pace, N for N times faster, or 0 for as fast as possible.
+// The replay runs in memory only: the snapshot, journal and archive files are not touched.
+// Returns 0 if the final state matches the recorded checksum.
+int runReplay(const char *path, double speed)
+{
+  static Room rooms[MAX_BOOKINGS];
+  int roomCount = 0, refused = 0, skipped = 0, operations = 0, capacity = 0, haveExpected = 0, expectedCount = 0;
+  unsigned long long expectedChecksum = 0;
+  long long *latencies = NULL;
+  char line[2 * JOURNAL_LINE_LENGTH];
+  Room booking;
+
+  FILE *trace = fopen(path, "r");
+  if (trace == NULL)
+  {
+    printf("Error: Unable to open trace file %s.\n", path);
+    return 1;
+  }
+
+  journalEnabled = 0;
+  businessDay = 0;
+
+  // Initial state
+  int version = 0, bookingId, recordStart = 0;
+  if (fgets(line, sizeof(line), trace) == NULL || sscanf(line, "T %d", &version) != 1 ||
+      version != TRACE_FORMAT_VERSION)
+  {
+    printf("Error: %s is not a version %d session trace (record it again with this version).\n", path,
+           TRACE_FORMAT_VERSION);
+    fclose(trace);
+    return 1;
+  }
+  nextBookingId = 1;
+  long operationsStart = ftell(trace);
+  while (fgets(line, sizeof(line), trace) != NULL)
+  {
+    if (line[0] == 'B' && sscanf(line, "B %d %n", &bookingId, &recordStart) == 1 && recordStart > 0 &&
+        parseJournalRecord(line + recordStart, &booking) && roomCount < MAX_BOOKINGS)
+    {
+      booking.bookingId = bookingId;
+      rooms[roomCount++] = booking;
+    }
+    else if (line[0] == 'D')
+      sscanf(line, "D %d", &businessDay);
+    else if (line[0] == 'I')
+      sscanf(line, "I %d", &nextBookingId);
+    else
+      break;
+    operationsStart = ftell(trace);
+  }
+  rebuildCheckoutHeap(rooms, roomCount);
+
+  fseek(trace, operationsStart, SEEK_SET);
+  long long replayStart = getMicroseconds();
+  while (fgets(line, sizeof(line), trace) != NULL)
+  {
+    long long offset;
+    int consumed = 0;
+
+    line[strcspn(line, "\n")] = '\0';
+    if (line[0] == 'E')
+    {
+      haveExpected = sscanf(line, "E %llu %d", &expectedChecksum, &expectedCount) == 2;
+      break;
+    }
+    if (sscanf(line, "%lld %n", &offset, &consumed) != 1 || consumed == 0)
+    {
+      skipped++;
+      continue;
+    }
+
+    // Keep the recorded pacing, scaled by the speed factor
+    if (speed > 0)
+      sleepMicroseconds((long long)(offset / speed) - (getMicroseconds() - replayStart));
+
+    if (operations == capacity)
+    {
+      capacity = capacity == 0 ? 1024 : capacity * 2;
+      long long *grown = realloc(latencies, capacity * sizeof(long long));
+      if (grown == NULL)
+      {
+        printf("Error: Out of memory after %d operations.\n", operations);
+        free(latencies);
+        fclose(trace);
+        return 1;
+      }
+      latencies = grown;
+    }
+
+    long long before = getMicroseconds();
+    int known = replayTraceOperation(rooms, &roomCount, line + consumed, &refused);
+    long long elapsed = getMicroseconds() - before;
+
+    if (known)
+      latencies[operations++] = elapsed;
+    else
+      skipped++;
+  }
+  long long wallMicros = getMicroseconds() - replayStart;
+  fclose(trace);
+
+  unsigned long long checksum = bookingStoreChecksum(rooms, roomCount);
+
+  printf("\n====================== REPLAY REPORT ======================\n");
+  printf("Trace:               %s\n", path);
+  if (speed > 0)
+    printf("Speed:               %.2fx recorded pace\n", speed);
+  else
+    printf("Speed:               maximum\n");
+  printf("Operations replayed: %d (%d refused, %d unreadable line(s) skipped)\n", operations, refused, skipped);
+  printf("Wall time:           %.3f s\n", wallMicros / 1000000.0);
+  if (wallMicros > 0)
+    printf("Throughput:          %.0f operations/s\n", operations * 1000000.0 / wallMicros);
+  if (operations > 0)
+  {
+    qsort(latencies, operations, sizeof(long long), compareLatency);
+    printf("Latency (us):        p50 %lld  p90 %lld  p99 %lld  max %lld\n",
+           latencies[(operations - 1) * 50 / 100], latencies[(operations - 1) * 90 / 100],
+           latencies[(operations - 1) * 99 / 100], latencies[operations - 1]);
+  }
+  printf("Availability cache:  %ld hit(s), %ld miss(es)\n", availabilityHits, availabilityMisses);
+  printf("Final state:         %d booking(s), checksum %016llx\n", roomCount, checksum);
+  printf("===========================================================\n");
+  free(latencies);
+
+  if (!haveExpected)
+  {
+    printf("The trace has no end record (session not saved); final state not verified.\n");
+    return 0;
+  }
+  if (checksum != expectedChecksum || roomCount != expectedCount)
+  {
+    printf("MISMATCH: the recorded session ended with %d booking(s), checksum %016llx.\n",
+           expectedCount, expectedChecksum);
+    return 2;
+  }
+  printf("Final state matches the recorded session.\n");
+  return 0;
+}
+
+#ifndef _WIN32
+// Function to check whether a process is still running
+int processAlive(int pid)
+{
+  return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+// Function to clear the slots of desks that stopped without closing the store.
+// Returns the number of other desks (not self) still attached. Call it with the lock held.
+int countSharedDesks(SharedStoreHeader *header, int self)
+{
+  int others = 0;
+  for (int i = 0; i < SHARED_STORE_MAX_DESKS; i++)
+  {
+    if (header->desks[i] != 0 && !processAlive(header->desks[i]))
+      header->desks[i] = 0;
+    if (header->desks[i] != 0 && header->desks[i] != self)
+      others++;
+  }
+  return others;
+}
+
+// Function to remove a store created by a build with another layout (for example another MAX_BOOKINGS).
+// Returns 1 if it is gone so a new one can be created, 0 if desks of that build are still using it.
+int retireSharedStore(SharedStoreHeader *header)
+{
+  for (int i = 0; i < SHARED_STORE_MAX_DESKS; i++)
+  {
+    if (processAlive(header->desks[i]))
+    {
+      printf("The shared booking store is in use by desks running another version of this program.\n");
+      printf("Close them (or run without --shared) and try again.\n");
+      return 0;
+    }
+  }
+
+  // Only the desk that marks it closed removes the name, so a fresh store is never unlinked by mistake
+  unsigned int magic = __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE);
+  if (magic != SHARED_STORE_CLOSED &&
+      __atomic_compare_exchange_n(&header->magic, &magic, SHARED_STORE_CLOSED, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    shm_unlink(sharedStoreName);
+  return 1;
+}
+
+// Function to (re)load the shared table from the snapshot and journal
+void loadSharedStore(SharedBookingStore *store)
+{
+  JournalReader journal = {0};
+  store->roomCount = 0;
+  followJournal(store->rooms, &store->roomCount, &journal);
+  store->businessDay = businessDay;
+  store->nextBookingId = nextBookingId;
+  store->archiveCommittedBytes = archiveCommittedBytes;
+  store->archiveCommittedBlocks = archiveCommittedBlocks;
+}
+
+// Function to wait until the shared table is loaded, loading it here if nobody else is.
+// A desk that died before finishing the load is replaced by the next desk to arrive.
+// Returns 1 when the table is ready, 0 if the store was retired meanwhile, -1 on timeout.
+int waitForSharedStore(SharedBookingStore *store, int self)
+{
+  for (int wait = 0; wait <= SHARED_STORE_WAIT_LIMIT; wait++)
+  {
+    unsigned int magic = __atomic_load_n(&store->header.magic, __ATOMIC_ACQUIRE);
+    if (magic == SHARED_STORE_MAGIC)
+      return 1;
+    if (magic == SHARED_STORE_CLOSED)
+      return 0;
+
+    int creator = __atomic_load_n(&store->header.creatorPid, __ATOMIC_ACQUIRE);
+    if ((creator == 0 || !processAlive(creator)) &&
+        __atomic_compare_exchange_n(&store->header.creatorPid, &creator, self, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    {
+      pthread_mutexattr_t attributes;
+      pthread_mutexattr_init(&attributes);
+      pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+      pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+      pthread_mutex_init(&store->lock, &attributes);
+      pthread_mutexattr_destroy(&attributes);
+
+      store->header.layoutVersion = SHARED_STORE_VERSION;
+      store->header.storeSize = sizeof(SharedBookingStore);
+      store->header.maxBookings = MAX_BOOKINGS;
+      memset(store->header.desks, 0, sizeof(store->header.desks));
+      store->header.desks[0] = self;
+      loadSharedStore(store);
+      store->changes = 1;
+      __atomic_store_n(&store->header.magic, SHARED_STORE_MAGIC, __ATOMIC_RELEASE);
+      return 1;
+    }
+    sleepMicroseconds(10000);
+  }
+  printf("Another desk (process %d) is still loading the shared booking store.\n", store->header.creatorPid);
+  return -1;
+}
+#endif
+
+// Function to attach to the shared booking store, creating it if this is the first desk.
+// The first desk loads the snapshot and journal into the shared table; the others wait until
+// it is ready. A store left behind by desks that all stopped without closing it is reloaded from
+// the saved files, and one made by a build with another layout is replaced once nobody uses it.
+// On success rooms and roomCount point into shared memory. Returns 0 on failure.
+int openSharedStore(Room **rooms, int **roomCount)
+{
+#ifdef _WIN32
+  (void)rooms;
+  (void)roomCount;
+  printf("The shared booking store is not available on this platform.\n");
+  return 0;
+#else
+  int self = getpid();
+  for (int attempt = 0; attempt < 50; attempt++)
+  {
+    if (attempt > 0)
+      sleepMicroseconds(20000);
+
+    int fd = shm_open(sharedStoreName, O_RDWR | O_CREAT, 0600);
+    if (fd == -1)
+      return 0;
+
+    // A new segment is empty until sized; every desk sizes it the same way, so racing here is harmless
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (info.st_size == 0 && ftruncate(fd, sizeof(SharedBookingStore)) != 0) ||
+        fstat(fd, &info) != 0)
+    {
+      close(fd);
+      return 0;
+    }
+
+    if (info.st_size != (off_t)sizeof(SharedBookingStore))
+    {
+      // Made by a build with another layout: only its header can be read safely
+      int retired = 1;
+      if (info.st_size < (off_t)sizeof(SharedStoreHeader))
+        shm_unlink(sharedStoreName);
+      else
+      {
+        SharedStoreHeader *header = mmap(NULL, sizeof(SharedStoreHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        retired = header != MAP_FAILED && retireSharedStore(header);
+        if (header != MAP_FAILED)
+          munmap(header, sizeof(SharedStoreHeader));
+      }
+      close(fd);
+      if (!retired)
+        return 0;
+      continue;
+    }
+
+    SharedBookingStore *store = mmap(NULL, sizeof(SharedBookingStore), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (store == MAP_FAILED)
+      return 0;
+
+    int ready = waitForSharedStore(store, self);
+    if (ready == 1 && (store->header.layoutVersion != SHARED_STORE_VERSION ||
+                       store->header.storeSize != sizeof(SharedBookingStore) ||
+                       store->header.maxBookings != MAX_BOOKINGS))
+      ready = retireSharedStore(&store->header) ? 0 : -1;
+    if (ready != 1)
+    {
+      munmap(store, sizeof(SharedBookingStore));
+      if (ready == -1)
+        return 0;
+      continue;
+    }
+
+    sharedStore = store;
+    lockBookingStore();
+    if (store->header.magic != SHARED_STORE_MAGIC)
+    {
+      // The last desk closed this store while we attached; start over with a fresh one
+      pthread_mutex_unlock(&store->lock);
+      sharedStore = NULL;
+      munmap(store, sizeof(SharedBookingStore));
+      continue;
+    }
+
+    int others = countSharedDesks(&store->header, self);
+    int slot = -1;
+    for (int i = 0; i < SHARED_STORE_MAX_DESKS && slot == -1; i++)
+    {
+      if (store->header.desks[i] == 0 || store->header.desks[i] == self)
+        slot = i;
+    }
+    if (slot == -1)
+    {
+      unlockBookingStore(0);
+      sharedStore = NULL;
+      munmap(store, sizeof(SharedBookingStore));
+      printf("The shared booking store already has %d desks attached.\n", SHARED_STORE_MAX_DESKS);
+      return 0;
+    }
+
+    if (others == 0 && store->header.desks[slot] != self)
+    {
+      // Every desk that used this table stopped without closing it; the saved files are the reference
+      printf("Recovering the shared booking store: no desk closed it cleanly. Reloading the saved bookings.\n");
+      loadSharedStore(store);
+      rebuildCheckoutHeap(store->rooms, store->roomCount);
+      invalidateAllAvailability();
+      sharedChangesSeen = ++store->changes;
+    }
+    store->header.desks[slot] = self;
+    printf("Shared booking store: %d desk(s) attached, %d booking(s).\n", others + 1, store->roomCount);
+    unlockBookingStore(0);
+
+    *rooms = store->rooms;
+    *roomCount = &store->roomCount;
+    return 1;
+  }
+  return 0;
+#endif
+}
+
+// Function to detach from the shared booking store.
+// The last desk to leave removes it, so the saved files are the only copy while nobody is working.
+// Desks that stopped without detaching are not counted.
+void closeSharedStore()
+{
+#ifndef _WIN32
+  if (sharedStore == NULL)
+    return;
+
+  int self = getpid();
+  lockBookingStore();
+  for (int i = 0; i < SHARED_STORE_MAX_DESKS; i++)
+  {
+    if (sharedStore->header.desks[i] == self)
+      sharedStore->header.desks[i] = 0;
+  }
+  if (countSharedDesks(&sharedStore->header, self) == 0)
+  {
+    sharedStore->header.magic = SHARED_STORE_CLOSED;
+    shm_unlink(sharedStoreName);
+  }
+  pthread_mutex_unlock(&sharedStore->lock);
+
+  munmap(sharedStore, sizeof(SharedBookingStore));
+  sharedStore = NULL;
+#endif
+}
+
+// Function to take the booking store lock before a change is committed.
+// Nothing to do for a private store. In shared mode, changes committed by other desks since this
+// process last held the lock make the local check-out heap and availability cache stale, so both
+// are rebuilt here.
+void lockBookingStore()
+{
+#ifndef _WIN32
+  if (sharedStore == NULL)
+    return;
+
+  if (pthread_mutex_lock(&sharedStore->lock) == EOWNERDEAD)
+  {
+    // A desk died holding the lock; its change may be half done, so everyone rebuilds
+    pthread_mutex_consistent(&sharedStore->lock);
+    sharedStore->changes++;
+    printf("Warning: another desk stopped in the middle of a change. Please check the latest bookings.\n");
+  }
+
+  if (sharedStore->changes != sharedChangesSeen)
+  {
+    rebuildCheckoutHeap(sharedStore->rooms, sharedStore->roomCount);
+    invalidateAllAvailability();
+    sharedChangesSeen = sharedStore->changes;
+  }
+  businessDay = sharedStore->businessDay;
+  nextBookingId = sharedStore->nextBookingId;
+  archiveCommittedBytes = sharedStore->archiveCommittedBytes;
+  archiveCommittedBlocks = sharedStore->archiveCommittedBlocks;
+#endif
+}
+
+// Function to release the booking store lock; changed tells other desks to refresh
+void unlockBookingStore(int changed)
+{
+#ifndef _WIN32
+  if (sharedStore == NULL)
+    return;
+
+  sharedStore->businessDay = businessDay;
+  sharedStore->nextBookingId = nextBookingId;
+  sharedStore->archiveCommittedBytes = archiveCommittedBytes;
+  sharedStore->archiveCommittedBlocks = archiveCommittedBlocks;
+  if (changed)
+    sharedChangesSeen = ++sharedStore->changes;
+  pthread_mutex_unlock(&sharedStore->lock);
+#else
+  (void)changed;
+#endif
+}
+
+// Function to get the store version (number of committed changes), 0 for a private store.
+// Call it with the lock held.
+unsigned int bookingStoreVersion()
+{
+#ifndef _WIN32
+  if (sharedStore != NULL)
+    return sharedStore->changes;
+#endif
+  return 0;
+}
+
+// Function to check whether two bookings hold the same data
+int sameBooking(const Room *a, const Room *b)
+{
+  char textA[JOURNAL_LINE_LENGTH], textB[JOURNAL_LINE_LENGTH];
+  formatJournalRecord(a, textA, sizeof(textA));
+  formatJournalRecord(b, textB, sizeof(textB));
+  return strcmp(textA, textB) == 0;
+}
+
+// Function to lock the store and find a booking again once the clerk has finished typing.
+// Returns its index with the lock held, or -1 (lock released) if another desk has
+// cancelled or changed the booking in the meantime.
+int relockBooking(Room rooms[], int roomCount, const Room *booking)
+{
+  lockBookingStore();
+#ifndef _WIN32
+  if (sharedStore != NULL)
+    roomCount = sharedStore->roomCount;
+#endif
+
+  int index = findBookingById(rooms, roomCount, booking->bookingId);
+  if (index == -1 || !sameBooking(&rooms[index], booking))
+  {
+    unlockBookingStore(0);
+    return -1;
+  }
+  return index;
+}
+
+// Function to give read-only menu items a consistent view of the bookings.
+// A private store is returned as it is; the shared table is copied under the lock, so a listing
+// never shows a booking half-way through another desk's change.
+Room *viewBookingStore(Room rooms[], int *roomCount, int *viewCount)
+{
+#ifndef _WIN32
+  static Room view[MAX_BOOKINGS];
+
+  if (sharedStore != NULL)
+  {
+    lockBookingStore();
+    *viewCount = *roomCount;
+    memcpy(view, rooms, *viewCount * sizeof(Room));
+    unlockBookingStore(0);
+    return view;
+  }
+#endif
+  *viewCount = *roomCount;
+  return rooms;
+}
+
+// Function to draw the next number of a simulation thread's generator (splitmix64)
+unsigned long long simNextRandom(unsigned long long *state)
+{
+  unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+// Function to draw a uniform number in [0, 1)
+double simUniform(unsigned long long *state)
+{
+  return (simNextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Function to draw a Poisson count as a sum of small chunks (Knuth's method), capped at cap
+int simPoisson(unsigned long long *state, int chunks, double chunkLimit, int cap)
+{
+  int count = 0;
+  for (int c = 0; c < chunks; c++)
+  {
+    double product = simUniform(state);
+    while (product > chunkLimit && count < cap)
+    {
+      count++;
+      product *= simUniform(state);
+    }
+  }
+  return count;
+}
+
+// Function to compute a square root by Newton's method (keeps the program free of the maths library)
+double simSquareRoot(double value)
+{
+  double root = value > 1 ? value : 1;
+  for (int k = 0; k < 100; k++)
+  {
+    double next = (root + value / root) / 2;
+    if (next >= root)
+      break;
+    root = next;
+  }
+  return value > 0 ? root : 0;
+}
+
+// Function to take memory from a simulation thread's arena (released all at once per scenario)
+void *simArenaAlloc(SimWorker *worker, size_t size)
+{
+  size = (size + 15) & ~(size_t)15;
+  if (worker->arenaUsed + size > worker->arenaSize)
+    return NULL;
+  void *block = worker->arena + worker->arenaUsed;
+  worker->arenaUsed += size;
+  return block;
+}
+
+// Function to group stays by day (counting sort). keys[i] is the stay's day offset, -1 to leave it out.
+// The stays of day d are order[offsets[d]] .. order[offsets[d + 1] - 1].
+void simBuildBuckets(const int keys[], int count, int days, int offsets[], int order[])
+{
+  memset(offsets, 0, (days + 1) * sizeof(int));
+  for (int i = 0; i < count; i++)
+  {
+    if (keys[i] >= 0)
+      offsets[keys[i] + 1]++;
+  }
+  for (int d = 0; d < days; d++)
+    offsets[d + 1] += offsets[d];
+  for (int i = 0; i < count; i++)
+  {
+    if (keys[i] >= 0)
+      order[offsets[keys[i]]++] = i;
+  }
+  for (int d = days; d > 0; d--)
+    offsets[d] = offsets[d - 1];
+  offsets[0] = 0;
+}
+
+// Function to add (delta 1) or remove (delta -1) a stay's nights from its type's booked-room counts
+void simBookNights(int bookCount[], const SimStay *stay, int delta)
+{
+  int from = stay->checkIn - simStartDay;
+  int to = from + stay->nights;
+  if (from < 0)
+    from = 0;
+  if (to > simCountDays)
+    to = simCountDays;
+  for (int d = from; d < to; d++)
+    bookCount[d] += delta;
+}
+
+// Function to check that every night of a stay is still under the type's booking limit
+int simCanBook(const int bookCount[], const SimStay *stay, int limit)
+{
+  int from = stay->checkIn - simStartDay;
+  int to = from + stay->nights;
+  if (to > simCountDays)
+    to = simCountDays;
+  for (int d = from; d < to; d++)
+  {
+    if (bookCount[d] >= limit)
+      return 0;
+  }
+  return 1;
+}
+
+// Function to run one scenario against every overbooking level.
+// The random draws (who cancels, who does not show up, which late requests arrive) are made once,
+// so the levels are compared on the same scenario. Guests who arrive are given rooms with
+// pickFreeRoom, the choice the front desk makes, over a map of the rooms in use that is updated
+// as guests arrive and check out. Returns 0 if the scenario does not fit in the thread's arena.
+int runSimulationScenario(SimWorker *worker, int scenario)
+{
+  int endDay = simStartDay + SIM_HORIZON_DAYS;
+  int maxStays = simBookedCount + simRequestBound;
+  int inHouseCount[MAX_ROOM_TYPES + 1];
+  int *inHouseRoom[MAX_ROOM_TYPES + 1];
+  int *inHouseCheckOut[MAX_ROOM_TYPES + 1];
+
+  worker->arenaUsed = 0;
+  worker->random = SIM_SEED ^ ((unsigned long long)scenario * 0xD1B54A32D192ED03ULL);
+
+  SimStay *stays = simArenaAlloc(worker, maxStays * sizeof(SimStay));
+  int *keys = simArenaAlloc(worker, maxStays * sizeof(int));
+  int *requestOrder = simArenaAlloc(worker, maxStays * sizeof(int));
+  int *cancelOrder = simArenaAlloc(worker, maxStays * sizeof(int));
+  int *arrivalOrder = simArenaAlloc(worker, maxStays * sizeof(int));
+  int *requestStart = simArenaAlloc(worker, (SIM_HORIZON_DAYS + 1) * sizeof(int));
+  int *cancelStart = simArenaAlloc(worker, (SIM_HORIZON_DAYS + 1) * sizeof(int));
+  int *arrivalStart = simArenaAlloc(worker, (SIM_HORIZON_DAYS + 1) * sizeof(int));
+  unsigned char *accepted = simArenaAlloc(worker, maxStays);
+  int *bookCount = simArenaAlloc(worker, (inventory.typeCount + 1) * simCountDays * sizeof(int));
+  unsigned char *occupied = simArenaAlloc(worker, MAX_ROOM_NUMBER + 1); // Guests in each room, by room number
+  int ok = stays && keys && requestOrder && cancelOrder && arrivalOrder && requestStart && cancelStart &&
+           arrivalStart && accepted && bookCount && occupied;
+  for (int t = 1; t <= inventory.typeCount; t++)
+  {
+    inHouseRoom[t] = simArenaAlloc(worker, inventory.types[t].count * sizeof(int));
+    inHouseCheckOut[t] = simArenaAlloc(worker, inventory.types[t].count * sizeof(int));
+    ok = ok && inHouseRoom[t] && inHouseCheckOut[t];
+  }
+  if (!ok)
+    return 0;
+
+  // Bookings already on the book: some cancel before they arrive, some do not show up
+  int n = 0;
+  for (int i = 0; i < simBookedCount; i++)
+  {
+    stays[n] = simBooked[i];
+    if (stays[n].checkIn >= simStartDay)
+    {
+      if (simUniform(&worker->random) < SIM_CANCEL_RATE && stays[n].checkIn > simStartDay)
+        stays[n].cancelDay = simStartDay + (int)(simNextRandom(&worker->random) % (stays[n].checkIn - simStartDay));
+      stays[n].showsUp = simUniform(&worker->random) >= SIM_NO_SHOW_RATE;
+    }
+    n++;
+  }
+
+  // Late booking requests for every check-in day of the horizon
+  for (int t = 1; t <= inventory.typeCount; t++)
+  {
+    for (int day = simStartDay; day < endDay; day++)
+    {
+      int requests = simPoisson(&worker->random, simRequestChunks[t], simRequestChunkLimit[t], simRequestCap[t]);
+      for (int r = 0; r < requests; r++)
+      {
+        SimStay *stay = &stays[n++];
+        stay->type = t;
+        stay->roomNumber = 0;
+        stay->checkIn = day;
+        stay->nights = 1 + (int)(simNextRandom(&worker->random) % SIM_MAX_NIGHTS);
+        stay->requestDay = day - (int)(simNextRandom(&worker->random) % (SIM_MAX_LEAD_DAYS + 1));
+        if (stay->requestDay < simStartDay)
+          stay->requestDay = simStartDay;
+        stay->cancelDay = -1;
+        if (simUniform(&worker->random) < SIM_CANCEL_RATE && day > stay->requestDay)
+          stay->cancelDay = stay->requestDay + (int)(simNextRandom(&worker->random) % (day - stay->requestDay));
+        stay->showsUp = simUniform(&worker->random) >= SIM_NO_SHOW_RATE;
+        stay->price = inventory.types[t].rate * stay->nights;
+      }
+    }
+  }
+
+  for (int i = 0; i < n; i++)
+    keys[i] = stays[i].requestDay >= 0 ? stays[i].requestDay - simStartDay : -1;
+  simBuildBuckets(keys, n, SIM_HORIZON_DAYS, requestStart, requestOrder);
+  for (int i = 0; i < n; i++)
+    keys[i] = stays[i].cancelDay >= 0 ? stays[i].cancelDay - simStartDay : -1;
+  simBuildBuckets(keys, n, SIM_HORIZON_DAYS, cancelStart, cancelOrder);
+  for (int i = 0; i < n; i++)
+    keys[i] = stays[i].checkIn >= simStartDay && stays[i].checkIn < endDay ? stays[i].checkIn - simStartDay : -1;
+  simBuildBuckets(keys, n, SIM_HORIZON_DAYS, arrivalStart, arrivalOrder);
+
+  for (int level = 0; level < SIM_LEVELS; level++)
+  {
+    SimLevelResult *result = &worker->levels[level];
+    int limit[MAX_ROOM_TYPES + 1];
+    double walkOuts = 0, revenue = 0, walkCost = 0;
+
+    for (int t = 1; t <= inventory.typeCount; t++)
+    {
+      int typeRooms = inventory.types[t].count;
+      limit[t] = typeRooms + (typeRooms * level * SIM_LEVEL_STEP_PERCENT + 99) / 100;
+      inHouseCount[t] = 0;
+    }
+    memcpy(bookCount, simBaseBookCount, (inventory.typeCount + 1) * simCountDays * sizeof(int));
+    memset(occupied, 0, MAX_ROOM_NUMBER + 1);
+    for (int i = 0; i < n; i++)
+      accepted[i] = stays[i].requestDay < 0;
+
+    // Guests already in house keep their rooms
+    for (int i = 0; i < simBookedCount; i++)
+    {
+      int t = stays[i].type;
+      if (stays[i].checkIn >= simStartDay || inHouseCount[t] == inventory.types[t].count)
+        continue;
+      int room = roomSlot(stays[i].roomNumber) != -1 ? stays[i].roomNumber : 0; // 0 is never a real room
+      occupied[room]++;
+      inHouseRoom[t][inHouseCount[t]] = room;
+      inHouseCheckOut[t][inHouseCount[t]++] = stays[i].checkIn + stays[i].nights;
+    }
+
+    for (int d = 0; d < SIM_HORIZON_DAYS; d++)
+    {
+      int day = simStartDay + d;
+
+      // Requests taken today, while every night of the stay is under the limit
+      for (int k = requestStart[d]; k < requestStart[d + 1]; k++)
+      {
+        const SimStay *stay = &stays[requestOrder[k]];
+        int *typeCount = bookCount + stay->type * simCountDays;
+        if (simCanBook(typeCount, stay, limit[stay->type]))
+        {
+          accepted[requestOrder[k]] = 1;
+          simBookNights(typeCount, stay, 1);
+          result->accepted++;
+        }
+      }
+
+      // Cancellations free their nights for later requests
+      for (int k = cancelStart[d]; k < cancelStart[d + 1]; k++)
+      {
+        int i = cancelOrder[k];
+        if (accepted[i])
+        {
+          accepted[i] = 0;
+          simBookNights(bookCount + stays[i].type * simCountDays, &stays[i], -1);
+        }
+      }
+
+      // Check-outs
+      for (int t = 1; t <= inventory.typeCount; t++)
+      {
+        for (int j = 0; j < inHouseCount[t];)
+        {
+          if (inHouseCheckOut[t][j] <= day)
+          {
+            occupied[inHouseRoom[t][j]]--;
+            inHouseCount[t]--;
+            inHouseRoom[t][j] = inHouseRoom[t][inHouseCount[t]];
+            inHouseCheckOut[t][j] = inHouseCheckOut[t][inHouseCount[t]];
+          }
+          else
+            j++;
+        }
+      }
+
+      // Arrivals get a room, or are walked to another hotel when the type is full
+      for (int k = arrivalStart[d]; k < arrivalStart[d + 1]; k++)
+      {
+        const SimStay *stay = &stays[arrivalOrder[k]];
+        int t = stay->type;
+        if (!accepted[arrivalOrder[k]] || !stay->showsUp)
+          continue;
+
+        // Every guest still in house is there tonight, so the rooms in use are exactly the occupied ones
+        int room = inHouseCount[t] < inventory.types[t].count ? pickFreeRoom(t, occupied, 0, 0, NULL) : -1;
+        if (room == -1)
+        {
+          walkOuts++;
+          walkCost += SIM_WALK_COST_NIGHTS * inventory.types[t].rate;
+          continue;
+        }
+        occupied[room]++;
+        inHouseRoom[t][inHouseCount[t]] = room;
+        inHouseCheckOut[t][inHouseCount[t]++] = day + stay->nights;
+        revenue += stay->price;
+      }
+    }
+
+    result->walkOuts += walkOuts;
+    result->revenue += revenue;
+    result->netRevenue += revenue - walkCost;
+    result->netRevenueSquared += (revenue - walkCost) * (revenue - walkCost);
+    if (walkOuts > 0)
+      result->scenariosWithWalkOut++;
+  }
+  return 1;
+}
+
+// Function to claim the next scenario number (shared by all simulation threads)
+int claimSimulationScenario()
+{
+#ifdef _WIN32
+  return simNextScenario++; // Single-threaded on Windows
+#else
+  return __sync_fetch_and_add(&simNextScenario, 1);
+#endif
+}
+
+// Function to read the scenario that failed, -1 if none has (shared by all simulation threads)
+int loadFailedScenario()
+{
+#ifdef _WIN32
+  return simFailedScenario; // Single-threaded on Windows
+#else
+  return __atomic_load_n(&simFailedScenario, __ATOMIC_ACQUIRE);
+#endif
+}
+
+// Function to record a scenario that could not run; every thread stops at its next claim
+void storeFailedScenario(int scenario)
+{
+#ifdef _WIN32
+  simFailedScenario = scenario;
+#else
+  __atomic_store_n(&simFailedScenario, scenario, __ATOMIC_RELEASE);
+#endif
+}
+
+// Function run by each simulation thread: take scenarios until none are left
+void *runSimulationWorker(void *arg)
+{
+  SimWorker *worker = (SimWorker *)arg;
+  int scenario;
+
+  while (loadFailedScenario() == -1 && (scenario = claimSimulationScenario()) < simScenarios)
+  {
+    if (!runSimulationScenario(worker, scenario))
+      storeFailedScenario(scenario); // The run is reported as failed
+  }
+  return NULL;
+}
+
+// Function to take the read-only snapshot the simulation threads share
+int prepareSimulation(Room rooms[], int roomCount, int startDay)
+{
+  simStartDay = startDay;
+  simCountDays = SIM_HORIZON_DAYS + SIM_MAX_NIGHTS;
+  simBookedCount = 0;
+  simBooked = malloc((roomCount > 0 ? roomCount : 1) * sizeof(SimStay));
+  if (simBooked == NULL)
+    return 0;
+
+  for (int i = 0; i < roomCount; i++)
+  {
+    int checkIn = dateToDayNumber(rooms[i].checkInDate);
+    if (!rooms[i].isBooked || !isValidRoomType(rooms[i].roomType) || checkIn + rooms[i].nights <= startDay)
+      continue;
+
+    SimStay *stay = &simBooked[simBookedCount++];
+    stay->type = rooms[i].roomType;
+    stay->roomNumber = checkIn < startDay ? rooms[i].roomNumber : 0;
+    stay->checkIn = checkIn;
+    stay->nights = rooms[i].nights;
+    stay->requestDay = -1;
+    stay->cancelDay = -1;
+    stay->showsUp = 1;
+    stay->price = rooms[i].totalPrice;
+    if (checkIn + rooms[i].nights - startDay > simCountDays)
+      simCountDays = checkIn + rooms[i].nights - startDay;
+  }
+
+  simBaseBookCount = calloc((inventory.typeCount + 1) * simCountDays, sizeof(int));
+  if (simBaseBookCount == NULL)
+    return 0;
+  for (int i = 0; i < simBookedCount; i++)
+    simBookNights(simBaseBookCount + simBooked[i].type * simCountDays, &simBooked[i], 1);
+
+  // Late requests per type and check-in day: mean chosen so requested room-nights are
+  // SIM_DEMAND times the type's capacity
+  simRequestBound = 0;
+  for (int t = 1; t <= inventory.typeCount; t++)
+  {
+    double mean = SIM_DEMAND * inventory.types[t].count / ((1 + SIM_MAX_NIGHTS) / 2.0);
+    int chunks = (int)(mean / 8) + 1;
+    double chunkMean = mean / chunks, term = 1, sum = 1;
+
+    for (int k = 1; k < 60; k++) // exp(chunkMean) by its series; chunkMean <= 8
+    {
+      term *= chunkMean / k;
+      sum += term;
+    }
+    simRequestChunks[t] = chunks;
+    simRequestChunkLimit[t] = 1 / sum;
+    simRequestCap[t] = (int)(4 * mean) + 20;
+    simRequestBound += simRequestCap[t] * SIM_HORIZON_DAYS;
+  }
+  return 1;
+}
+
+// Function to run scenarios from startDay over the given bookings and sum each level's results
+// into total[]. threads <= 0 uses one per processor. arenaSize is each thread's working memory,
+// 0 to size it for the bookings (a smaller one makes scenarios fail, which the run reports).
+// Returns the number of threads that ran, or 0 after printing why there are no results.
+int simulateOverbooking(Room rooms[], int roomCount, int startDay, int scenarios, int threads, size_t arenaSize,
+                        SimLevelResult total[])
+{
+#ifdef _WIN32
+  threads = 1;
+#else
+  if (threads <= 0)
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  if (threads < 1)
+    threads = 1;
+  if (threads > SIM_MAX_THREADS)
+    threads = SIM_MAX_THREADS;
+  if (threads > scenarios)
+    threads = scenarios;
+
+  SimWorker *workers = calloc(threads, sizeof(SimWorker));
+  int ok = workers != NULL && prepareSimulation(rooms, roomCount, startDay);
+
+  // Everything one scenario needs, with room for rounding each block up to 16 bytes
+  size_t maxStays = simBookedCount + simRequestBound;
+  if (arenaSize == 0)
+    arenaSize = maxStays * (sizeof(SimStay) + 4 * sizeof(int) + 1) +
+                3 * (SIM_HORIZON_DAYS + 1) * sizeof(int) +
+                (size_t)(inventory.typeCount + 1) * simCountDays * sizeof(int) +
+                (size_t)inventory.roomCount * 2 * sizeof(int) + (MAX_ROOM_NUMBER + 1) +
+                16 * (13 + 2 * MAX_ROOM_TYPES);
+  for (int k = 0; ok && k < threads; k++)
+  {
+    workers[k].arena = malloc(arenaSize);
+    workers[k].arenaSize = arenaSize;
+    ok = workers[k].arena != NULL;
+  }
+
+  int running = 0;
+  if (ok)
+  {
+    simScenarios = scenarios;
+    simNextScenario = 0;
+    storeFailedScenario(-1);
+
+    // This thread is worker 0; the others are started next to it
+    running = 1;
+#ifndef _WIN32
+    while (running < threads && pthread_create(&workers[running].thread, NULL, runSimulationWorker,
+                                               &workers[running]) == 0)
+    {
+      running++;
+    }
+#endif
+    runSimulationWorker(&workers[0]);
+#ifndef _WIN32
+    for (int k = 1; k < running; k++)
+      pthread_join(workers[k].thread, NULL);
+#endif
+  }
+
+  if (!ok)
+    printf("Error: Not enough memory for the simulation.\n");
+  else if (loadFailedScenario() != -1)
+  {
+    printf("Error: Scenario %d did not fit in the simulation's working memory. No results reported.\n",
+           loadFailedScenario());
+    running = 0;
+  }
+
+  memset(total, 0, SIM_LEVELS * sizeof(SimLevelResult));
+  for (int k = 0; k < running; k++)
+  {
+    for (int level = 0; level < SIM_LEVELS; level++)
+    {
+      total[level].accepted += workers[k].levels[level].accepted;
+      total[level].walkOuts += workers[k].levels[level].walkOuts;
+      total[level].revenue += workers[k].levels[level].revenue;
+      total[level].netRevenue += workers[k].levels[level].netRevenue;
+      total[level].netRevenueSquared += workers[k].levels[level].netRevenueSquared;
+      total[level].scenariosWithWalkOut += workers[k].levels[level].scenariosWithWalkOut;
+    }
+  }
+
+  for (int k = 0; workers != NULL && k < threads; k++)
+    free(workers[k].arena);
+  free(workers);
+  free(simBooked);
+  free(simBaseBookCount);
+  simBooked = NULL;
+  simBaseBookCount = NULL;
+  return running;
+}
+
+// Function to run the overbooking simulation and print expected walk-outs and revenue per level
+int runOverbookingSimulation(int scenarios, int threads)
+{
+  static Room rooms[MAX_BOOKINGS];
+  int roomCount = 0;
+  JournalReader reader = {0};
+  Date today;
+
+  followJournal(rooms, &roomCount, &reader);
+
+  // The simulation starts on the business date, or today if no night audit has run yet
+  if (businessDay > 0)
+    dayNumberToDate(businessDay, &today);
+  else
+  {
+    time_t now = time(NULL);
+    struct tm *local = localtime(&now);
+    today.day = local->tm_mday;
+    today.month = local->tm_mon + 1;
+    today.year = local->tm_year + 1900;
+  }
+
+  SimLevelResult total[SIM_LEVELS];
+  long long started = getMicroseconds();
+  int running = simulateOverbooking(rooms, roomCount, dateToDayNumber(today), scenarios, threads, 0, total);
+  double seconds = (getMicroseconds() - started) / 1000000.0;
+  if (running == 0)
+    return 1;
+
+  Date end;
+  dayNumberToDate(simStartDay + SIM_HORIZON_DAYS - 1, &end);
+  printf("\n========================== OVERBOOKING SIMULATION ==========================\n");
+  printf("Period:     %02d/%02d/%04d - %02d/%02d/%04d (%d days)\n", today.day, today.month, today.year,
+         end.day, end.month, end.year, SIM_HORIZON_DAYS);
+  printf("Book:       %d stay(s) in progress or to come, %d room(s)\n", simBookedCount, inventory.roomCount);
+  printf("Model:      late demand %.0f%% of capacity, %.0f%% cancel, %.0f%% no-show, walk-out costs %.0f night(s)\n",
+         SIM_DEMAND * 100, SIM_CANCEL_RATE * 100, SIM_NO_SHOW_RATE * 100, SIM_WALK_COST_NIGHTS);
+  printf("Scenarios:  %d on %d thread(s) in %.2f s\n", scenarios, running, seconds);
+  printf("----------------------------------------------------------------------------\n");
+  printf("%-7s %-7s %-10s %-10s %-9s %-14s %s\n", "Level", "Extra", "Late bkgs", "Walk-outs", "P(walk)",
+         "Revenue", "Net revenue (95% CI)");
+  printf("----------------------------------------------------------------------------\n");
+
+  int best = 0;
+  for (int level = 0; level < SIM_LEVELS; level++)
+  {
+    const SimLevelResult *result = &total[level];
+    int extra = 0;
+    for (int t = 1; t <= inventory.typeCount; t++)
+      extra += (inventory.types[t].count * level * SIM_LEVEL_STEP_PERCENT + 99) / 100;
+
+    double meanNet = result->netRevenue / scenarios;
+    double variance = result->netRevenueSquared / scenarios - meanNet * meanNet;
+    double margin = variance > 0 && scenarios > 1 ? 1.96 * simSquareRoot(variance / (scenarios - 1)) : 0;
+    char label[16], walkChance[16];
+    snprintf(label, sizeof(label), "+%d%%", level * SIM_LEVEL_STEP_PERCENT);
+    snprintf(walkChance, sizeof(walkChance), "%.1f%%", 100.0 * result->scenariosWithWalkOut / scenarios);
+    printf("%-7s %-7d %-10.1f %-10.2f %-9s $%-13.2f $%.2f +/- %.2f\n", label, extra,
+           (double)result->accepted / scenarios, result->walkOuts / scenarios, walkChance,
+           result->revenue / scenarios, meanNet, margin);
+    if (meanNet > total[best].netRevenue / scenarios)
+      best = level;
+  }
+  printf("----------------------------------------------------------------------------\n");
+  printf("Best expected net revenue: +%d%% (%.2f walk-out(s) a year)\n", best * SIM_LEVEL_STEP_PERCENT,
+         total[best].walkOuts / scenarios);
+  printf("============================================================================\n");
+  return 0;
+}